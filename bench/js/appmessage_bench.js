@@ -0,0 +1,208 @@
+// AppMessage throughput of the phone-side protocols in src/js/app.js, measured
+// against a fake watch under a range of outbox sizes (see pebble_env.js for
+// the link model).
+//
+//   node bench/js/appmessage_bench.js [--rolls N] [--pages N] [--latency MS]
+//                                     [--failure RATE] [--verbose]
+//
+// roll-sync: the watch packs and frames rollLog records like src/roll_log.c and
+//            merges queued ones up to the payload limit like src/msg_queue.c,
+//            retrying NACKs with the same backoff.
+// history:   the watch walks the history a page at a time with one page of
+//            prefetch, like src/history.c.
+// Rates are per simulated second; "cpu" is real time spent inside app.js.
+
+var frame = require('../../src/js/frame');
+var createEnv = require('./pebble_env').createEnv;
+var makeRandom = require('./pebble_env').makeRandom;
+
+var OUTBOX_SIZES = [64, 128, 256, 512, 1024, 2048];
+var BACKOFF_MIN_MS = 250;
+var BACKOFF_MAX_MS = 8000;
+var HISTORY_PAGE_SIZE = 6;
+var HISTORY_REQUEST_TIMEOUT_MS = 5000;
+
+function parseArgs(argv) {
+  var args = {rolls: 2000, pages: 100, latency: 40, failure: 0.02, verbose: false};
+  for (var i = 2; i < argv.length; i++) {
+    var name = argv[i].replace(/^--/, '');
+    if (name === 'verbose') {
+      args.verbose = true;
+    } else if (name in args) {
+      args[name] = parseFloat(argv[++i]);
+    }
+  }
+  return args;
+}
+
+// A plausible table: mostly a few dice, now and then a big pool.
+function makeRoll(random, seq) {
+  var groups = [];
+  var groupCount = 1 + Math.floor(random() * (random() < 0.1 ? 8 : 3));
+  for (var g = 0; g < groupCount; g++) {
+    var kind = Math.floor(random() * 8);
+    var count = 1 + Math.floor(random() * (random() < 0.1 ? 64 : 4));
+    var results = [];
+    for (var d = 0; d < count; d++) {
+      results.push(Math.floor(random() * 100));
+    }
+    groups.push({kind: kind, results: results});
+  }
+  var record = [seq & 0xFF, (seq >> 8) & 0xFF, groups.length];
+  groups.forEach(function(group) {
+    record.push(group.kind, group.results.length);
+    record = record.concat(group.results);
+  });
+  return frame.encode(record);
+}
+
+function benchRollSync(outboxSize, args) {
+  var env = createEnv({
+    outboxSize: outboxSize, latencyMs: args.latency, failureRate: args.failure, verbose: args.verbose
+  });
+  env.start();
+  env.run();
+
+  var random = makeRandom(7);
+  var queue = [];
+  for (var seq = 0; seq < args.rolls; seq++) {
+    var record = makeRoll(random, seq);
+    if (record.length <= env.watch.payloadMax) {
+      queue.push(record);
+    }
+  }
+  var rolls = queue.length;
+  var backoff = 0;
+  var retries = 0;
+  var startedAt = env.clock.now;
+  var finishedAt = startedAt;
+
+  function sendNext() {
+    if (queue.length === 0) {
+      return;
+    }
+    var payload = [];
+    var merged = 0;
+    while (merged < queue.length && payload.length + queue[merged].length <= env.watch.payloadMax) {
+      payload = payload.concat(queue[merged]);
+      merged++;
+    }
+    env.watch.send('rollLog', {records: payload}, function() {
+      queue.splice(0, merged);
+      finishedAt = env.clock.now;
+      backoff = 0;
+      sendNext();
+    }, function() {
+      retries++;
+      backoff = backoff ? Math.min(backoff * 2, BACKOFF_MAX_MS) : BACKOFF_MIN_MS;
+      env.clock.after(backoff, sendNext);
+    });
+  }
+  sendNext();
+  env.run();
+
+  var stored = JSON.parse(env.storage['rollLog.meta'] || '{"start":0,"end":0}');
+  return report(env, env.stats.toPhone, finishedAt - startedAt, {
+    rolls: rolls, stored: stored.end - stored.start, retries: retries
+  });
+}
+
+function benchHistory(outboxSize, args) {
+  var env = createEnv({
+    outboxSize: outboxSize, latencyMs: args.latency, failureRate: args.failure, verbose: args.verbose
+  });
+  env.start();
+  env.run();
+
+  // Seed the phone's history directly; only the paging is measured here.
+  var random = makeRandom(11);
+  var seeded = [];
+  for (var seq = 0; seq < args.pages * HISTORY_PAGE_SIZE; seq++) {
+    seeded = seeded.concat(makeRoll(random, seq));
+  }
+  env.app.storeRolls(env.app.decodeRollLog(seeded));
+
+  var received = {};
+  var requested = {};
+  var timeouts = 0;
+  var startedAt = env.clock.now;
+  var finishedAt = startedAt;
+
+  // A lost reply is only noticed by the watch's request timeout.
+  function request(page) {
+    if (page >= args.pages || requested[page] || received[page]) {
+      return;
+    }
+    requested[page] = true;
+    env.watch.send('historyRequest', {first: page * HISTORY_PAGE_SIZE, count: HISTORY_PAGE_SIZE});
+    env.clock.after(HISTORY_REQUEST_TIMEOUT_MS, function() {
+      if (!received[page] && timeouts < args.pages) {
+        timeouts++;
+        requested[page] = false;
+        request(page);
+      }
+    });
+  }
+  env.watch.onMessage(function(message) {
+    if (!message || message.type !== 'historyPage') {
+      return;
+    }
+    var index = message.first / HISTORY_PAGE_SIZE;
+    received[index] = true;
+    finishedAt = env.clock.now;
+    request(index + 1);
+    request(index + 2);
+  });
+  request(0);
+  request(1);
+  env.run();
+
+  return report(env, env.stats.toWatch, finishedAt - startedAt, {
+    pages: Object.keys(received).length, timeouts: timeouts
+  });
+}
+
+function report(env, channel, elapsedMs, extra) {
+  var seconds = elapsedMs / 1000;
+  var result = {
+    outbox: env.options.outboxSize,
+    messages: channel.messages,
+    failed: channel.failed,
+    msgsPerSec: seconds > 0 ? channel.messages / seconds : 0,
+    bytesPerSec: seconds > 0 ? channel.bytes / seconds : 0,
+    cpuMs: env.stats.cpuMs
+  };
+  Object.keys(extra).forEach(function(key) {
+    result[key] = extra[key];
+  });
+  return result;
+}
+
+function pad(value, width) {
+  var text = (typeof value === 'number' && value % 1 !== 0) ? value.toFixed(1) : String(value);
+  while (text.length < width) {
+    text = ' ' + text;
+  }
+  return text;
+}
+
+function printTable(title, rows, columns) {
+  console.log('\n' + title);
+  console.log(columns.map(function(column) { return pad(column, 12); }).join(''));
+  rows.forEach(function(row) {
+    console.log(columns.map(function(column) { return pad(row[column], 12); }).join(''));
+  });
+}
+
+function main() {
+  var args = parseArgs(process.argv);
+  console.log('latency ' + args.latency + ' ms, failure rate ' + args.failure);
+  printTable('roll-sync (' + args.rolls + ' rolls)',
+             OUTBOX_SIZES.map(function(size) { return benchRollSync(size, args); }),
+             ['outbox', 'rolls', 'stored', 'messages', 'retries', 'msgsPerSec', 'bytesPerSec', 'cpuMs']);
+  printTable('history (' + args.pages + ' pages)',
+             OUTBOX_SIZES.map(function(size) { return benchHistory(size, args); }),
+             ['outbox', 'pages', 'messages', 'failed', 'timeouts', 'msgsPerSec', 'bytesPerSec', 'cpuMs']);
+}
+
+main();
@@ -0,0 +1,108 @@
+// Stand-in scoreboard server for the HTTP export in src/js/app.js. Prints
+// every batch it receives.
+//
+//   node bench/js/export_server.js [--port 8080] [--fail-every N]
+//   node bench/js/export_server.js --drive ROLLS [--format csv] [--interval S]
+//
+// --fail-every answers every Nth POST with a 503 to exercise the retry path.
+// --drive starts the server on a free port, points app.js (in the Node
+// harness, on real timers) at it, feeds ROLLS rolls from a fake watch in
+// bursts, and exits once all of them arrived, printing how many POSTs it took.
+
+var http = require('http');
+var frame = require('../../src/js/frame');
+var createEnv = require('./pebble_env').createEnv;
+
+function parseArgs(argv) {
+  var args = {port: 8080, failEvery: 0, drive: 0, format: 'json', interval: 1};
+  for (var i = 2; i < argv.length; i++) {
+    var name = argv[i].replace(/^--/, '').replace(/-([a-z])/g, function(m, c) { return c.toUpperCase(); });
+    if (name in args) {
+      var value = argv[++i];
+      args[name] = (typeof args[name] === 'number') ? parseFloat(value) : value;
+    }
+  }
+  return args;
+}
+
+// Roll count in one POST body, for either format.
+function countRolls(type, body) {
+  if (type.indexOf('csv') >= 0) {
+    return body.trim().split('\n').length - 1;
+  }
+  return JSON.parse(body).rolls.length;
+}
+
+function startServer(args, onBatch, ready) {
+  var posts = 0;
+  var server = http.createServer(function(request, response) {
+    var chunks = [];
+    request.on('data', function(chunk) {
+      chunks.push(chunk);
+    });
+    request.on('end', function() {
+      posts++;
+      if (args.failEvery > 0 && posts % args.failEvery === 0) {
+        console.log('POST #' + posts + ': answering 503');
+        response.writeHead(503);
+        response.end();
+        return;
+      }
+      var body = Buffer.concat(chunks).toString();
+      var type = request.headers['content-type'] || '';
+      var rolls = countRolls(type, body);
+      console.log('POST #' + posts + ': ' + rolls + ' roll(s), ' + body.length + ' bytes, ' + type);
+      response.writeHead(204);
+      response.end();
+      onBatch(rolls, body);
+    });
+  });
+  server.listen(args.port, function() {
+    ready(server, server.address().port);
+  });
+  return server;
+}
+
+function drive(args) {
+  var received = 0;
+  var server = startServer(Object.assign({}, args, {port: 0}), function(rolls) {
+    received += rolls;
+    if (received >= args.drive) {
+      console.log('All ' + received + ' roll(s) exported in ' + env.stats.httpRequests + ' POST(s)');
+      server.close();
+      process.exit(0);
+    }
+  }, function(srv, port) {
+    env.storage['config'] = JSON.stringify({
+      export: {url: 'http://127.0.0.1:' + port + '/rolls', format: args.format, intervalSec: args.interval}
+    });
+    env.start();
+
+    // A burst of rolls every 100 ms, one rollLog record each.
+    var seq = 0;
+    var feeder = setInterval(function() {
+      for (var i = 0; i < 5 && seq < args.drive; i++, seq++) {
+        var record = [seq & 0xFF, seq >> 8, 1, 1, 2, 1 + seq % 6, 1 + (seq * 7) % 6];
+        env.watch.send('rollLog', {records: frame.encode(record)});
+      }
+      if (seq >= args.drive) {
+        clearInterval(feeder);
+      }
+    }, 100);
+  });
+  var env = createEnv({realTime: true, latencyMs: 5});
+
+  setTimeout(function() {
+    console.log('Timed out with ' + received + '/' + args.drive + ' roll(s)');
+    process.exit(1);
+  }, 60000);
+}
+
+var args = parseArgs(process.argv);
+if (args.drive > 0) {
+  drive(args);
+} else {
+  startServer(args, function() {}, function(server, port) {
+    console.log('Listening on http://0.0.0.0:' + port + '/');
+  });
+}
@@ -0,0 +1,129 @@
+// Payload efficiency of the roll log's framing (src/frame.c) against sending
+// the same roll as a per-key AppMessage dictionary, for 64-die rolls.
+//
+//   node bench/js/framing_bench.js [--rolls N] [--outbox BYTES]
+//
+// per-value: one tuple per field and per result, the usual Tuplet approach.
+// per-group: one tuple per field, results as one byte array per group.
+// framed:    the shipped layout, framed records in the PAYLOAD byte array
+//            after the message id.
+// "bytes" is the whole dictionary as dict_calc_buffer_size() counts it, and
+// "rolls/msg" how many such rolls fit one outbox when merged. The decode rate
+// is app.js unframing and parsing merged rollLog bodies, in real time.
+
+var frame = require('../../src/js/frame');
+var createEnv = require('./pebble_env').createEnv;
+var makeRandom = require('./pebble_env').makeRandom;
+
+// dict_calc_buffer_size(): 1 byte header, then 7 bytes per tuple plus data.
+var DICT_HEADER = 1;
+var TUPLE_HEADER = 7;
+
+// Each shape is 64 dice in total, as [kind, count] groups.
+var SHAPES = [
+  {name: '64d6', groups: [[1, 64]]},
+  {name: '32d6+32d20', groups: [[1, 32], [5, 32]]},
+  {name: '8 x 8d%', groups: [[7, 8], [7, 8], [7, 8], [7, 8], [7, 8], [7, 8], [7, 8], [7, 8]]}
+];
+
+function parseArgs(argv) {
+  var args = {rolls: 20000, outbox: 2048};
+  for (var i = 2; i < argv.length; i += 2) {
+    args[argv[i].replace(/^--/, '')] = Number(argv[i + 1]);
+  }
+  return args;
+}
+
+function makeRecord(random, seq, groups) {
+  var record = [seq & 0xFF, (seq >> 8) & 0xFF, groups.length];
+  groups.forEach(function(group) {
+    record.push(group[0], group[1]);
+    for (var d = 0; d < group[1]; d++) {
+      record.push(Math.floor(random() * 100));
+    }
+  });
+  return record;
+}
+
+// seq (u16), group count, then kind/count/results per group.
+function perValueSize(groups) {
+  var size = DICT_HEADER + (TUPLE_HEADER + 2) + (TUPLE_HEADER + 1);
+  groups.forEach(function(group) {
+    size += 2 * (TUPLE_HEADER + 1) + group[1] * (TUPLE_HEADER + 1);
+  });
+  return size;
+}
+
+function perGroupSize(groups) {
+  var size = DICT_HEADER + (TUPLE_HEADER + 2) + (TUPLE_HEADER + 1);
+  groups.forEach(function(group) {
+    size += 2 * (TUPLE_HEADER + 1) + TUPLE_HEADER + group[1];
+  });
+  return size;
+}
+
+// One PAYLOAD tuple holding the message id and the frames.
+function framedSize(framedBytes) {
+  return DICT_HEADER + TUPLE_HEADER + 1 + framedBytes;
+}
+
+function pad(value, width) {
+  var text = (typeof value === 'number' && value % 1 !== 0) ? value.toFixed(2) : String(value);
+  while (text.length < width) {
+    text = ' ' + text;
+  }
+  return text;
+}
+
+function fitPerMessage(outbox, fixed, perRoll) {
+  return Math.max(0, Math.floor((outbox - fixed) / perRoll));
+}
+
+function main() {
+  var args = parseArgs(process.argv);
+  var random = makeRandom(5);
+  var env = createEnv({outboxSize: args.outbox});
+
+  console.log('outbox ' + args.outbox + ' bytes; sizes per 64-die roll');
+  var columns = ['shape', 'raw', 'per-value', 'per-group', 'framed', 'vs-value', 'rolls/msg'];
+  console.log(columns.map(function(column) { return pad(column, 12); }).join(''));
+  SHAPES.forEach(function(shape) {
+    var record = makeRecord(random, 1, shape.groups);
+    var framed = frame.encode(record);
+    var perValue = perValueSize(shape.groups);
+    // Per-key dictionaries can't be merged, so they fit one roll per message
+    // at most; framed rolls share the tuple and message headers.
+    var merged = fitPerMessage(args.outbox, DICT_HEADER + TUPLE_HEADER + 1, framed.length);
+    console.log([shape.name, record.length, perValue, perGroupSize(shape.groups), framedSize(framed.length),
+                 (perValue / framedSize(framed.length)).toFixed(1) + 'x', merged]
+      .map(function(value) { return pad(value, 12); }).join(''));
+  });
+
+  // Decode throughput over bodies merged the way msg_queue merges them.
+  var bodies = [];
+  var body = [];
+  var payloadMax = env.watch.payloadMax;
+  var decodedBytes = 0;
+  for (var seq = 0; seq < args.rolls; seq++) {
+    var shape = SHAPES[seq % SHAPES.length];
+    var framed = frame.encode(makeRecord(random, seq, shape.groups));
+    if (body.length + framed.length > payloadMax) {
+      bodies.push(body);
+      body = [];
+    }
+    body = body.concat(framed);
+    decodedBytes += framed.length;
+  }
+  bodies.push(body);
+
+  var started = process.hrtime.bigint();
+  var rolls = 0;
+  bodies.forEach(function(merged) {
+    rolls += env.app.decodeRollLog(merged).length;
+  });
+  var seconds = Number(process.hrtime.bigint() - started) / 1e9;
+  console.log('\ndecoded ' + rolls + '/' + args.rolls + ' rolls from ' + bodies.length + ' message(s): ' +
+              Math.round(rolls / seconds) + ' rolls/s, ' + (decodedBytes / seconds / 1e6).toFixed(1) + ' MB/s');
+}
+
+main();
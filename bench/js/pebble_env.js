@@ -0,0 +1,297 @@
+// Runs src/js/app.js under Node with a mocked `Pebble` global and a fake watch
+// on the other end of a simulated AppMessage link.
+//
+// Time is simulated: every message costs `latencyMs` plus its size over
+// `bytesPerMs`, and a seeded `failureRate` NACKs some of them, so runs are
+// repeatable and independent of the machine. Both directions allow one
+// message in flight at a time, like the real transport. app.js timers run on
+// the same clock. Pass `realTime: true` to use wall-clock timers instead, e.g.
+// when app.js talks to a real HTTP server through the XMLHttpRequest shim.
+//
+//   var env = createEnv({latencyMs: 40, failureRate: 0.02, outboxSize: 512});
+//   env.watch.send(protocol.encode('rollLog', {records: bytes}), onAck, onNack);
+//   env.run();  // until no events are left
+
+var fs = require('fs');
+var http = require('http');
+var path = require('path');
+var vm = require('vm');
+
+var JS_DIR = path.join(__dirname, '..', '..', 'src', 'js');
+var APP_JS = path.join(JS_DIR, 'app.js');
+var protocol = require(path.join(JS_DIR, 'protocol'));
+
+// Same dictionary accounting as dict_calc_buffer_size(): a 1-byte header plus
+// 7 bytes per tuple on top of the data.
+function dictSize(dict) {
+  var size = 1;
+  Object.keys(dict).forEach(function(key) {
+    var value = dict[key];
+    size += 7 + (Array.isArray(value) ? value.length : (typeof value === 'string' ? value.length + 1 : 4));
+  });
+  return size;
+}
+
+// xorshift32, so failures land on the same messages every run.
+function makeRandom(seed) {
+  var state = seed >>> 0 || 1;
+  return function() {
+    state ^= state << 13;
+    state >>>= 0;
+    state ^= state >>> 17;
+    state ^= state << 5;
+    state >>>= 0;
+    return state / 4294967296;
+  };
+}
+
+function createRealClock() {
+  var started = Date.now();
+  var clock = {now: 0};
+  clock.after = function(delay, fn) {
+    return setTimeout(function() {
+      clock.now = Date.now() - started;
+      fn();
+    }, delay);
+  };
+  clock.cancel = clearTimeout;
+  clock.run = function() {};
+  return clock;
+}
+
+function createClock() {
+  var events = [];
+  var clock = {now: 0, sequence: 0};
+  clock.at = function(time, fn) {
+    var event = {time: time, order: clock.sequence++, fn: fn};
+    events.push(event);
+    return event;
+  };
+  clock.after = function(delay, fn) {
+    return clock.at(clock.now + delay, fn);
+  };
+  clock.cancel = function(event) {
+    var index = events.indexOf(event);
+    if (index >= 0) {
+      events.splice(index, 1);
+    }
+  };
+  clock.run = function(limit) {
+    while (events.length > 0) {
+      events.sort(function(a, b) {
+        return (a.time - b.time) || (a.order - b.order);
+      });
+      var next = events.shift();
+      if (limit !== undefined && next.time > limit) {
+        events.unshift(next);
+        return;
+      }
+      clock.now = next.time;
+      next.fn();
+    }
+  };
+  return clock;
+}
+
+// One direction of the link. Messages queue up and go out one at a time.
+function createChannel(clock, options, random, deliver, stats) {
+  var queue = [];
+  var busy = false;
+
+  function pump() {
+    if (busy || queue.length === 0) {
+      return;
+    }
+    busy = true;
+    var item = queue.shift();
+    var size = dictSize(item.dict);
+    var cost = options.latencyMs + size / options.bytesPerMs;
+    clock.after(cost, function() {
+      busy = false;
+      if (size > options.outboxSize || random() < options.failureRate) {
+        stats.failed++;
+        if (item.onFail) {
+          item.onFail({error: size > options.outboxSize ? 'overflow' : 'nack'});
+        }
+      } else {
+        stats.messages++;
+        stats.bytes += size;
+        deliver(item.dict);
+        if (item.onOk) {
+          item.onOk({});
+        }
+      }
+      pump();
+    });
+  }
+
+  return function(dict, onOk, onFail) {
+    queue.push({dict: dict, onOk: onOk, onFail: onFail});
+    pump();
+  };
+}
+
+// Just enough XMLHttpRequest for app.js, backed by Node's http module.
+function createXhrClass(onRequest) {
+  function FakeXMLHttpRequest() {
+    this.status = 0;
+    this.responseText = '';
+    this.headers = {};
+  }
+  FakeXMLHttpRequest.prototype.open = function(method, url) {
+    this.method = method;
+    this.url = url;
+  };
+  FakeXMLHttpRequest.prototype.setRequestHeader = function(name, value) {
+    this.headers[name] = value;
+  };
+  FakeXMLHttpRequest.prototype.send = function(body) {
+    var xhr = this;
+    onRequest(xhr, body);
+    var request = http.request(xhr.url, {method: xhr.method, headers: xhr.headers}, function(response) {
+      var chunks = [];
+      response.on('data', function(chunk) {
+        chunks.push(chunk);
+      });
+      response.on('end', function() {
+        xhr.status = response.statusCode;
+        xhr.responseText = Buffer.concat(chunks).toString();
+        if (xhr.onload) {
+          xhr.onload();
+        }
+      });
+    });
+    request.on('error', function() {
+      if (xhr.onerror) {
+        xhr.onerror();
+      }
+    });
+    request.end(body);
+  };
+  return FakeXMLHttpRequest;
+}
+
+// PebbleKit JS bundles src/js/*.js as CommonJS modules (enableMultiJS); this
+// loads them into the sandbox the same way, once each.
+function createRequire(sandbox) {
+  var cache = {};
+  return function(name) {
+    var file = path.join(JS_DIR, name.replace(/^\.\//, '').replace(/\.js$/, '') + '.js');
+    if (!cache[file]) {
+      var module = {exports: {}};
+      var wrapper = vm.runInContext('(function(module, exports, require) {' + fs.readFileSync(file, 'utf8') +
+                                    '\n})', sandbox, {filename: file});
+      wrapper(module, module.exports, sandbox.require);
+      cache[file] = module;
+    }
+    return cache[file].exports;
+  };
+}
+
+function createEnv(options) {
+  options = Object.assign({
+    latencyMs: 40,
+    failureRate: 0,
+    outboxSize: 2048,
+    bytesPerMs: 4,
+    seed: 1
+  }, options || {});
+
+  var clock = options.realTime ? createRealClock() : createClock();
+  var random = makeRandom(options.seed);
+  var listeners = {};
+  var storage = {};
+  var stats = {
+    toPhone: {messages: 0, bytes: 0, failed: 0},
+    toWatch: {messages: 0, bytes: 0, failed: 0},
+    cpuMs: 0,
+    httpRequests: 0
+  };
+  var watchHandlers = [];
+
+  function dispatch(event, payload) {
+    (listeners[event] || []).forEach(function(listener) {
+      var started = process.hrtime.bigint();
+      listener(payload);
+      stats.cpuMs += Number(process.hrtime.bigint() - started) / 1e6;
+    });
+  }
+
+  var toWatch = createChannel(clock, options, random, function(dict) {
+    var message = protocol.decode(dict[protocol.MESSAGE_KEY] || []);
+    watchHandlers.forEach(function(handler) {
+      handler(message);
+    });
+  }, stats.toWatch);
+  var toPhone = createChannel(clock, options, random, function(dict) {
+    dispatch('appmessage', {payload: dict});
+  }, stats.toPhone);
+
+  var sandbox = {
+    console: {log: options.verbose ? console.log : function() {}},
+    Pebble: {
+      addEventListener: function(event, listener) {
+        (listeners[event] = listeners[event] || []).push(listener);
+      },
+      sendAppMessage: function(dict, onOk, onFail) {
+        toWatch(dict, onOk, onFail);
+      },
+      openURL: function() {}
+    },
+    localStorage: {
+      getItem: function(key) {
+        return Object.prototype.hasOwnProperty.call(storage, key) ? storage[key] : null;
+      },
+      setItem: function(key, value) {
+        storage[key] = String(value);
+      },
+      removeItem: function(key) {
+        delete storage[key];
+      }
+    }
+  };
+  sandbox.Date = {now: function() { return Math.floor(clock.now); }};
+  sandbox.setTimeout = function(fn, delay) {
+    return clock.after(delay || 0, fn);
+  };
+  sandbox.clearTimeout = function(timer) {
+    clock.cancel(timer);
+  };
+  sandbox.XMLHttpRequest = createXhrClass(function() {
+    stats.httpRequests++;
+  });
+  vm.createContext(sandbox);
+  sandbox.require = createRequire(sandbox);
+  vm.runInContext(fs.readFileSync(APP_JS, 'utf8'), sandbox, {filename: APP_JS});
+
+  return {
+    options: options,
+    clock: clock,
+    stats: stats,
+    storage: storage,
+    app: sandbox,
+    watch: {
+      // Largest message body, as msg_queue computes it: one PAYLOAD tuple
+      // minus the message id byte.
+      payloadMax: options.outboxSize - dictSize({x: []}) - 1,
+      // Frames `fields` as the named protocol message and sends it.
+      send: function(name, fields, onAck, onNack) {
+        var dict = {};
+        dict[protocol.MESSAGE_KEY] = protocol.encode(name, fields);
+        toPhone(dict, onAck, onNack);
+      },
+      // Handlers get the decoded message ({type, ...fields}).
+      onMessage: function(handler) {
+        watchHandlers.push(handler);
+      }
+    },
+    start: function() {
+      dispatch('ready', {});
+    },
+    run: function(limit) {
+      clock.run(limit);
+    }
+  };
+}
+
+module.exports = {protocol: protocol, createEnv: createEnv, dictSize: dictSize, makeRandom: makeRandom};
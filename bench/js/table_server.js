@@ -0,0 +1,184 @@
+// Stand-in table aggregator for the shared table feed in src/js/app.js.
+//
+//   node bench/js/table_server.js [--port 8090] [--lose-every N]
+//   node bench/js/table_server.js --drive ROLLS [--players 4] [--lose-every N]
+//
+// POST /tables/<table>/rolls  {rolls: [{source, player, seq, total, groups}]}
+//   appends rolls not seen before; a repeated (source, seq) is ignored.
+// GET  /tables/<table>/feed?since=CURSOR
+//   {cursor, entries} with everything after CURSOR, oldest first, at most
+//   FEED_PAGE_MAX of the newest. A cursor from before a restart starts over.
+//
+// --lose-every stores every Nth POST but answers 503, as if the response got
+// lost, so the phone retries rolls the table already has.
+// --drive runs PLAYERS phones (the Node harness, real timers) against the
+// server, each with a fake watch rolling ROLLS times in bursts, and reports
+// what every watch received once all feeds are drained.
+
+var http = require('http');
+var url = require('url');
+var frame = require('../../src/js/frame');
+var createEnv = require('./pebble_env').createEnv;
+
+var FEED_PAGE_MAX = 100;
+
+function parseArgs(argv) {
+  var args = {port: 8090, loseEvery: 0, drive: 0, players: 4};
+  for (var i = 2; i < argv.length; i++) {
+    var name = argv[i].replace(/^--/, '').replace(/-([a-z])/g, function(m, c) { return c.toUpperCase(); });
+    if (name in args) {
+      args[name] = parseFloat(argv[++i]);
+    }
+  }
+  return args;
+}
+
+function startServer(args, ready) {
+  var tables = {};
+  var stats = {posts: 0, polls: 0, stored: 0, duplicates: 0};
+
+  function table(name) {
+    return tables[name] = tables[name] || {entries: [], keys: {}};
+  }
+
+  var server = http.createServer(function(request, response) {
+    var parsed = url.parse(request.url, true);
+    var match = /^\/tables\/([^/]+)\/(rolls|feed)$/.exec(parsed.pathname);
+    if (!match) {
+      response.writeHead(404);
+      response.end();
+      return;
+    }
+    var current = table(decodeURIComponent(match[1]));
+    var chunks = [];
+    request.on('data', function(chunk) {
+      chunks.push(chunk);
+    });
+    request.on('end', function() {
+      if (match[2] === 'rolls' && request.method === 'POST') {
+        stats.posts++;
+        var rolls = [];
+        try {
+          rolls = JSON.parse(Buffer.concat(chunks).toString()).rolls || [];
+        } catch (e) {
+          response.writeHead(400);
+          response.end();
+          return;
+        }
+        rolls.forEach(function(roll) {
+          var key = roll.source + ':' + roll.seq;
+          if (current.keys[key]) {
+            stats.duplicates++;
+            return;
+          }
+          current.keys[key] = true;
+          current.entries.push(roll);
+          stats.stored++;
+        });
+        response.writeHead((args.loseEvery > 0 && stats.posts % args.loseEvery === 0) ? 503 : 204);
+        response.end();
+        return;
+      }
+
+      stats.polls++;
+      var since = parseInt(parsed.query.since, 10) || 0;
+      if (since > current.entries.length) {
+        since = 0;
+      }
+      var from = Math.max(since, current.entries.length - FEED_PAGE_MAX);
+      response.writeHead(200, {'Content-Type': 'application/json'});
+      response.end(JSON.stringify({cursor: current.entries.length, entries: current.entries.slice(from)}));
+    });
+  });
+  server.listen(args.port, function() {
+    ready(server, server.address().port, stats, tables);
+  });
+  return server;
+}
+
+// What one fake watch got: feed messages, entries, and any entry it saw twice.
+function watchFeedStats(env) {
+  var result = {messages: 0, entries: 0, duplicates: 0, keys: {}};
+  env.watch.onMessage(function(message) {
+    if (!message || message.type !== 'tableFeed') {
+      return;
+    }
+    result.messages++;
+    frame.decode(message.entries).records.forEach(function(record) {
+      var source = (record[0] | (record[1] << 8) | (record[2] << 16) | (record[3] << 24)) >>> 0;
+      var key = source + ':' + (record[4] | (record[5] << 8));
+      result.entries++;
+      if (result.keys[key]) {
+        result.duplicates++;
+      }
+      result.keys[key] = true;
+    });
+  });
+  return result;
+}
+
+function drive(args) {
+  startServer(Object.assign({}, args, {port: 0}), function(server, port, stats, tables) {
+    var players = [];
+    for (var p = 0; p < args.players; p++) {
+      var env = createEnv({realTime: true, latencyMs: 5, seed: p + 1});
+      env.storage['config'] = JSON.stringify({
+        table: {url: 'http://127.0.0.1:' + port, name: 'bench', player: 'P' + (p + 1)}
+      });
+      players.push({env: env, feed: watchFeedStats(env), seq: 0});
+      env.start();
+    }
+
+    // Every player rolls a burst of 1-3 dice sets every 200 ms.
+    var feeder = setInterval(function() {
+      var busy = false;
+      players.forEach(function(player) {
+        var burst = 1 + Math.floor(Math.random() * 3);
+        for (var i = 0; i < burst && player.seq < args.drive; i++, player.seq++) {
+          var seq = player.seq;
+          player.env.watch.send('rollLog', {records: frame.encode([seq & 0xFF, seq >> 8, 1, 1, 2, 1 + seq % 6, 6])});
+        }
+        busy = busy || player.seq < args.drive;
+      });
+      if (!busy) {
+        clearInterval(feeder);
+      }
+    }, 200);
+
+    var expected = args.players * args.drive;
+    var watcher = setInterval(function() {
+      var stored = tables.bench ? tables.bench.entries.length : 0;
+      var drained = players.every(function(player) {
+        var table = player.env.app.s_table;
+        return table.cursor === expected && table.outbox.length === 0 && !table.sending;
+      });
+      if (stored < expected || !drained) {
+        return;
+      }
+      clearInterval(watcher);
+      console.log('table: ' + stored + ' roll(s) from ' + stats.posts + ' POST(s), ' + stats.duplicates +
+                  ' duplicate(s) ignored, ' + stats.polls + ' poll(s)');
+      players.forEach(function(player, index) {
+        var feed = player.feed;
+        console.log('P' + (index + 1) + ': ' + feed.entries + ' feed entr' + (feed.entries === 1 ? 'y' : 'ies') +
+                    ' in ' + feed.messages + ' message(s), ' + feed.duplicates + ' duplicate(s)');
+      });
+      server.close();
+      process.exit(players.some(function(player) { return player.feed.duplicates > 0; }) ? 1 : 0);
+    }, 250);
+
+    setTimeout(function() {
+      console.log('Timed out: ' + (tables.bench ? tables.bench.entries.length : 0) + '/' + expected + ' roll(s)');
+      process.exit(1);
+    }, 120000);
+  });
+}
+
+var args = parseArgs(process.argv);
+if (args.drive > 0) {
+  drive(args);
+} else {
+  startServer(args, function(server, port) {
+    console.log('Listening on http://0.0.0.0:' + port + '/tables/<table>/');
+  });
+}
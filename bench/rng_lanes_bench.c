@@ -0,0 +1,75 @@
+// Host benchmark for bulk rolling: dicecore's one-at-a-time rng_bounded()
+// against the eight-lane generator in tools/rng_lanes.c on each ISA, counting
+// faces into a histogram as dicesim does.
+//
+//   cc -O2 -iquote src -iquote tools bench/rng_lanes_bench.c tools/rng_lanes.c src/dicecore/rng.c -o rng_lanes_bench
+//   ./rng_lanes_bench [dice]
+//
+// Single-threaded; dicesim multiplies this by the core count. Every lane ISA
+// starts from the same seed, so their histograms must match exactly.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dicecore/rng.h"
+#include "rng_lanes.h"
+
+static const int s_ranges[] = {6, 20, 100};
+
+static double prv_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+  const long dice = (argc > 1) ? atol(argv[1]) : 200000000L;
+  const uint64_t rounds = (uint64_t)dice / RNG_LANES;
+  const uint32_t seed[4] = {1, 2, 3, 4};
+  RngState base;
+  rng_seed(&base, seed);
+
+  printf("%-6s %-12s %14s %10s\n", "range", "path", "M dice/s", "vs scalar");
+  for (size_t r = 0; r < sizeof(s_ranges) / sizeof(s_ranges[0]); ++r) {
+    const uint32_t range = (uint32_t)s_ranges[r];
+    uint64_t counts[RNG_LANES_RANGE_MAX] = {0};
+
+    RngState rng = base;
+    double started = prv_now_ns();
+    for (uint64_t i = 0; i < rounds * RNG_LANES; ++i) {
+      counts[rng_bounded(&rng, range)]++;
+    }
+    const double scalar_rate = rounds * RNG_LANES / (prv_now_ns() - started) * 1e3;
+    printf("d%-5u %-12s %14.1f %9.2fx\n", range, "rng_bounded", scalar_rate, 1.0);
+
+    uint64_t reference[RNG_LANES_RANGE_MAX];
+    bool have_reference = false;
+    for (int isa = 0; isa < RNG_LANES_ISA_COUNT; ++isa) {
+      if (!rng_lanes_isa_supported((RngLanesIsa)isa)) {
+        printf("d%-5u lanes/%-6s %14s\n", range, rng_lanes_isa_name((RngLanesIsa)isa), "n/a");
+        continue;
+      }
+      RngLanes lanes;
+      rng_lanes_seed(&lanes, &base);
+      memset(counts, 0, sizeof(counts));
+      started = prv_now_ns();
+      rng_lanes_histogram(&lanes, (RngLanesIsa)isa, range, rounds, counts);
+      const double rate = rounds * RNG_LANES / (prv_now_ns() - started) * 1e3;
+      const bool match = !have_reference || memcmp(counts, reference, range * sizeof(counts[0])) == 0;
+      if (!have_reference) {
+        memcpy(reference, counts, sizeof(reference));
+        have_reference = true;
+      }
+      printf("d%-5u lanes/%-6s %14.1f %9.2fx%s\n", range, rng_lanes_isa_name((RngLanesIsa)isa), rate,
+             rate / scalar_rate, match ? "" : "  MISMATCH");
+      if (!match) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
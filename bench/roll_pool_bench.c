@@ -0,0 +1,63 @@
+// Host benchmark for the per-value cost of the roll hot path: drawing straight
+// from the generator versus popping from a primed RollPool.
+//
+//   cc -std=c99 -O2 -iquote src bench/roll_pool_bench.c src/dicecore/rng.c src/dicecore/roll_pool.c -o roll_pool_bench
+//   ./roll_pool_bench [values]
+//
+// The pool numbers exclude refills on purpose: on the watch those run in idle
+// slices between animation frames, not while a batch is being set up. On the
+// watch itself, build with `pebble build -- --dice-debug` and read the
+// "Batch setup" log lines for the same comparison in wall-clock ms.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dicecore/rng.h"
+#include "dicecore/roll_pool.h"
+
+static const int s_ranges[] = {6, 20, 100};
+
+static double prv_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv) {
+  const long values = (argc > 1) ? atol(argv[1]) : 20000000L;
+  const uint32_t seed[4] = {1, 2, 3, 4};
+  rng_reseed(seed);
+
+  printf("%-6s %14s %14s\n", "range", "direct ns/val", "pool ns/val");
+  for (size_t r = 0; r < sizeof(s_ranges) / sizeof(s_ranges[0]); ++r) {
+    const int range = s_ranges[r];
+    volatile int sink = 0;
+
+    double started = prv_now_ns();
+    for (long i = 0; i < values; ++i) {
+      sink += rng_roll(range);
+    }
+    const double direct_ns = (prv_now_ns() - started) / values;
+
+    RollPool pool;
+    roll_pool_reset(&pool, range);
+    double pool_ns_total = 0;
+    long taken = 0;
+    while (taken < values) {
+      roll_pool_fill(&pool, ROLL_POOL_CAPACITY);
+      started = prv_now_ns();
+      for (int i = 0; i < ROLL_POOL_CAPACITY && taken < values; ++i, ++taken) {
+        sink += roll_pool_take(&pool, range);
+      }
+      pool_ns_total += prv_now_ns() - started;
+    }
+    const double pool_ns = pool_ns_total / values;
+
+    printf("d%-5d %14.2f %14.2f\n", range, direct_ns, pool_ns);
+    (void)sink;
+  }
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include "comm.h"
+
+#include <string.h>
+
+#include "msg_queue.h"
+
+// -----------------------------------------------------------------------------
+// COMM MODULE
+// -----------------------------------------------------------------------------
+// Thin transport layer: sizes and opens AppMessage, dispatches incoming
+// messages by protocol id, and forwards outbox results to msg_queue. Every
+// message is one PAYLOAD byte array framed as [message id][body] (see
+// protocol/dice_protocol.json), so there is no per-field tuple overhead.
+// Feature modules subscribe to the ids they care about instead of registering
+// AppMessage callbacks themselves (AppMessage only keeps one of each).
+//
+// Safe tweaks:
+// - COMM_INBOX_SIZE/COMM_OUTBOX_LIMIT trade heap for larger messages.
+
+#define COMM_INBOX_SIZE 512
+#define COMM_OUTBOX_LIMIT 2048
+
+typedef struct {
+  ProtoMessageId id;
+  CommHandler handler;
+  void *context;
+} CommSubscription;
+
+typedef struct {
+  CommSubscription subscriptions[COMM_MAX_HANDLERS];
+  int subscription_count;
+  uint32_t outbox_size;
+} CommState;
+
+static CommState s_comm;
+
+static void prv_inbox_received(DictionaryIterator *iter, void *context) {
+  const Tuple *tuple = dict_find(iter, MESSAGE_KEY_PAYLOAD);
+  if (!tuple || tuple->type != TUPLE_BYTE_ARRAY || tuple->length < 1) {
+    return;
+  }
+  const uint8_t id = tuple->value->data[0];
+  const uint8_t *body = &tuple->value->data[1];
+  const uint16_t length = tuple->length - 1;
+
+  if (id == PROTO_MSG_APP_READY) {
+    msg_queue_set_ready(true);
+  }
+  for (int i = 0; i < s_comm.subscription_count; ++i) {
+    const CommSubscription *sub = &s_comm.subscriptions[i];
+    if (sub->id == id) {
+      sub->handler(body, length, sub->context);
+    }
+  }
+}
+
+static void prv_inbox_dropped(AppMessageResult reason, void *context) {
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Inbox dropped: %d", (int)reason);
+}
+
+static void prv_outbox_sent(DictionaryIterator *iter, void *context) {
+  msg_queue_handle_sent();
+}
+
+static void prv_outbox_failed(DictionaryIterator *iter, AppMessageResult reason, void *context) {
+  msg_queue_handle_failed(reason);
+}
+
+void comm_init(void) {
+  memset(&s_comm, 0, sizeof(s_comm));
+
+  s_comm.outbox_size = app_message_outbox_size_maximum();
+  if (s_comm.outbox_size > COMM_OUTBOX_LIMIT) {
+    s_comm.outbox_size = COMM_OUTBOX_LIMIT;
+  }
+
+  app_message_register_inbox_received(prv_inbox_received);
+  app_message_register_inbox_dropped(prv_inbox_dropped);
+  app_message_register_outbox_sent(prv_outbox_sent);
+  app_message_register_outbox_failed(prv_outbox_failed);
+  app_message_open(COMM_INBOX_SIZE, s_comm.outbox_size);
+
+  msg_queue_init(s_comm.outbox_size);
+}
+
+void comm_deinit(void) {
+  msg_queue_deinit();
+  app_message_deregister_callbacks();
+  s_comm.subscription_count = 0;
+}
+
+bool comm_subscribe(ProtoMessageId id, CommHandler handler, void *context) {
+  if (!handler || s_comm.subscription_count >= COMM_MAX_HANDLERS) {
+    return false;
+  }
+  s_comm.subscriptions[s_comm.subscription_count++] = (CommSubscription) {
+    .id = id,
+    .handler = handler,
+    .context = context,
+  };
+  return true;
+}
+
+uint32_t comm_outbox_size(void) {
+  return s_comm.outbox_size;
+}
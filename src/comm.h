@@ -0,0 +1,18 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "protocol.h"
+
+#define COMM_MAX_HANDLERS 8
+
+typedef void (*CommHandler)(const uint8_t *body, uint16_t length, void *context);
+
+// Opens AppMessage once for the whole app and routes incoming messages to the
+// handler subscribed for their protocol id. Outgoing traffic goes through
+// msg_queue.
+void comm_init(void);
+void comm_deinit(void);
+
+bool comm_subscribe(ProtoMessageId id, CommHandler handler, void *context);
+uint32_t comm_outbox_size(void);
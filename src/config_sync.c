@@ -0,0 +1,115 @@
+#include "config_sync.h"
+
+#include <string.h>
+
+#include "comm.h"
+#include "preset.h"
+#include "roll_profile.h"
+
+// -----------------------------------------------------------------------------
+// CONFIG SYNC MODULE
+// -----------------------------------------------------------------------------
+// Receiving end of the settings page. PebbleKit JS diffs the user's settings
+// against what it last synced and sends only the records that changed, so a
+// save costs one small message instead of a full re-sync.
+//
+// Both messages (preset/profile in protocol/dice_protocol.json) are a plain
+// run of records:
+//
+// preset:  repeated [slot][group count][name length][name...] + [kind][count]
+//          per group; a group count of CONFIG_SYNC_DELETE clears the slot and
+//          carries nothing else.
+// profile: repeated [profile id][spin ms:2][ticks min][ticks max]
+//          [final hold ms:2][result hold ms:2]
+// All integers are little-endian.
+//
+// Safe tweaks:
+// - Keep the layouts in step with encodePreset()/encodeProfile() in app.js.
+
+#define CONFIG_SYNC_DELETE 0xFF
+#define CONFIG_SYNC_PROFILE_SIZE 9
+
+typedef struct {
+  ConfigChangedHandler on_changed;
+  void *changed_context;
+} ConfigSync;
+
+static ConfigSync s_sync;
+
+static uint16_t prv_read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Stops at the first malformed record; the ones before it still apply.
+static void prv_presets_received(const uint8_t *data, uint16_t length, void *context) {
+  int offset = 0;
+  int applied = 0;
+  while (offset + 2 <= length) {
+    const int slot = data[offset];
+    const int groups = data[offset + 1];
+    offset += 2;
+    if (groups == CONFIG_SYNC_DELETE) {
+      preset_delete(slot);
+      ++applied;
+      continue;
+    }
+    if (offset >= length) {
+      break;
+    }
+    const int name_length = data[offset++];
+    if (groups > MAX_DICE_GROUPS || offset + name_length + groups * 2 > length) {
+      break;
+    }
+
+    Preset preset;
+    memset(&preset, 0, sizeof(preset));
+    const int copied = (name_length < PRESET_NAME_LENGTH - 1) ? name_length : PRESET_NAME_LENGTH - 1;
+    memcpy(preset.name, &data[offset], copied);
+    offset += name_length;
+    preset.group_count = (uint8_t)groups;
+    for (int g = 0; g < groups; ++g) {
+      preset.kinds[g] = data[offset++];
+      preset.counts[g] = data[offset++];
+    }
+    if (preset_store(slot, &preset)) {
+      ++applied;
+    } else {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Rejected preset for slot %d", slot);
+    }
+  }
+  if (applied > 0 && s_sync.on_changed) {
+    s_sync.on_changed(s_sync.changed_context);
+  }
+}
+
+static void prv_profiles_received(const uint8_t *data, uint16_t length, void *context) {
+  int applied = 0;
+  for (int offset = 0; offset + CONFIG_SYNC_PROFILE_SIZE <= length; offset += CONFIG_SYNC_PROFILE_SIZE) {
+    const RollProfileTiming timing = {
+      .spin_ms = prv_read_u16(&data[offset + 1]),
+      .spin_ticks_min = data[offset + 3],
+      .spin_ticks_max = data[offset + 4],
+      .final_hold_ms = prv_read_u16(&data[offset + 5]),
+      .result_hold_ms = prv_read_u16(&data[offset + 7]),
+    };
+    if (roll_profile_set_timing((RollProfileId)data[offset], &timing)) {
+      ++applied;
+    } else {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Rejected timing for profile %d", data[offset]);
+    }
+  }
+  if (applied > 0 && s_sync.on_changed) {
+    s_sync.on_changed(s_sync.changed_context);
+  }
+}
+
+void config_sync_init(ConfigChangedHandler on_changed, void *context) {
+  s_sync.on_changed = on_changed;
+  s_sync.changed_context = context;
+  comm_subscribe(PROTO_MSG_PRESET, prv_presets_received, NULL);
+  comm_subscribe(PROTO_MSG_PROFILE, prv_profiles_received, NULL);
+}
+
+void config_sync_deinit(void) {
+  s_sync.on_changed = NULL;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef void (*ConfigChangedHandler)(void *context);
+
+// Applies preset and profile changes sent by the phone's settings page.
+// `on_changed` runs after each message that changed something.
+void config_sync_init(ConfigChangedHandler on_changed, void *context);
+void config_sync_deinit(void);
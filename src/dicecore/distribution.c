@@ -0,0 +1,68 @@
+#include "distribution.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// DISTRIBUTION MODULE
+// -----------------------------------------------------------------------------
+// Exact distribution of a configuration's grand total, convolved one die at a
+// time in fixed point. odds.c runs it on the watch for small pools; the host
+// tools cross-check it against Monte Carlo (dicesim -x), so changes to the
+// math here can be validated before they reach the odds players see.
+//
+// Safe tweaks:
+// - DISTRIBUTION_FIXED_ONE trades headroom (sides * weight must fit 32 bits)
+//   for truncation error.
+
+// Faces of one die as values: offset + stride * k for k in [0, sides).
+static void prv_kind_faces(DiceKind kind, int *offset, int *stride, int *sides) {
+  *stride = model_kind_tens_mode(kind) ? 10 : 1;
+  *offset = model_kind_zero_based(kind) ? 0 : *stride;
+  *sides = model_kind_roll_sides(kind);
+}
+
+void distribution_range(const DiceModel *model, int *min_total, int *max_total) {
+  *min_total = 0;
+  *max_total = 0;
+  for (int g = 0; g < model_group_count(model); ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    int offset, stride, sides;
+    prv_kind_faces((DiceKind)group->die_def_index, &offset, &stride, &sides);
+    *min_total += group->count * offset;
+    *max_total += group->count * (offset + stride * (sides - 1));
+  }
+}
+
+// dist[r] holds the weight of (current minimum + r); each die spreads it over
+// its faces. The pass runs from the top down so it can happen in place: new[r]
+// only reads old entries at or below r.
+void distribution_compute(const DiceModel *model, uint32_t *dist) {
+  int min_total, max_total;
+  distribution_range(model, &min_total, &max_total);
+  memset(dist, 0, (max_total - min_total + 1) * sizeof(uint32_t));
+  dist[0] = DISTRIBUTION_FIXED_ONE;
+
+  int length = 1;
+  for (int g = 0; g < model_group_count(model); ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    int offset, stride, sides;
+    prv_kind_faces((DiceKind)group->die_def_index, &offset, &stride, &sides);
+    for (int d = 0; d < group->count; ++d) {
+      const int new_length = length + stride * (sides - 1);
+      for (int r = new_length - 1; r >= 0; --r) {
+        uint32_t sum = 0;
+        for (int k = 0; k < sides; ++k) {
+          const int from = r - stride * k;
+          if (from < 0) {
+            break;
+          }
+          if (from < length) {
+            sum += dist[from];
+          }
+        }
+        dist[r] = sum / sides;
+      }
+      length = new_length;
+    }
+  }
+}
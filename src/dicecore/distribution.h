@@ -0,0 +1,16 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "model.h"
+
+// Fixed-point weight of the whole distribution before any truncation.
+#define DISTRIBUTION_FIXED_ONE (1u << 30)
+
+// Smallest and largest grand total the model's groups can roll.
+void distribution_range(const DiceModel *model, int *min_total, int *max_total);
+// Exact distribution of the grand total: dist[r] is the fixed-point weight of
+// min_total + r. `dist` must hold max_total - min_total + 1 entries. Each die
+// truncates, so the weights sum to a little under DISTRIBUTION_FIXED_ONE;
+// divide by their sum, not by DISTRIBUTION_FIXED_ONE.
+void distribution_compute(const DiceModel *model, uint32_t *dist);
@@ -8,7 +8,10 @@
 // -----------------------------------------------------------------------------
 // Keeps all dice configuration and roll results in one place. Other modules
 // interact with the model exclusively through the functions declared in
-// model.h, so they never need to touch DiceGroup internals directly.
+// model.h, so they never need to touch DiceGroup internals directly. Like the
+// rest of src/dicecore it only uses the C standard library, so the watch app,
+// host benchmarks and server-side tools all link the same engine (wscript
+// builds it as build/host/libdicecore.a).
 //
 // Safe tweaks:
 // - Update s_die_defs if you add/remove a die type.
@@ -113,14 +116,19 @@ int model_get_selected_die_index(const DiceModel *model) {
 // Handles adding/clearing dice groups and exposes read-only accessors that the
 // UI can consume when it needs to render a summary of configured dice.
 bool model_commit_group(DiceModel *model) {
-  if (model->group_count >= MAX_DICE_GROUPS) {
+  return model_add_group(model, (DiceKind)model->selected_die_index, model->selected_count);
+}
+
+bool model_add_group(DiceModel *model, DiceKind kind, int count) {
+  const DieDefinition *def = prv_die_def_at_index(kind);
+  if (!def || count < 1 || count > MAX_DICE_PER_GROUP || model->group_count >= MAX_DICE_GROUPS) {
     return false;
   }
 
   DiceGroup *group = &model->groups[model->group_count++];
-  group->die_def_index = model->selected_die_index;
-  group->sides = model_get_selected_sides(model);
-  group->count = model->selected_count;
+  group->die_def_index = kind;
+  group->sides = def->display_sides;
+  group->count = count;
   memset(group->results, 0, sizeof(group->results));
   return true;
 }
@@ -198,6 +206,16 @@ int model_roll_total_dice(const DiceModel *model) {
   return total;
 }
 
+int model_roll_total(const DiceModel *model) {
+  int total = 0;
+  for (int g = 0; g < model->group_count; ++g) {
+    for (int d = 0; d < model->groups[g].count; ++d) {
+      total += model->groups[g].results[d];
+    }
+  }
+  return total;
+}
+
 int model_group_count(const DiceModel *model) {
   return model->group_count;
 }
@@ -250,6 +268,11 @@ DiceKind model_current_roll_kind(const DiceModel *model) {
   return (DiceKind)group->die_def_index;
 }
 
+const char *model_kind_label(DiceKind kind) {
+  const DieDefinition *def = prv_die_def_at_index(kind);
+  return def ? def->label : "d?";
+}
+
 int model_kind_roll_sides(DiceKind kind) {
   const DieDefinition *def = prv_die_def_at_index(kind);
   return def ? def->roll_sides : 0;
@@ -264,3 +287,15 @@ bool model_kind_tens_mode(DiceKind kind) {
   const DieDefinition *def = prv_die_def_at_index(kind);
   return def ? def->tens_mode : false;
 }
+
+int model_kind_face_value(DiceKind kind, int raw_value) {
+  const DieDefinition *def = prv_die_def_at_index(kind);
+  if (!def || raw_value <= 0) {
+    return 0;
+  }
+  int value = def->zero_based ? raw_value - 1 : raw_value;
+  if (def->tens_mode) {
+    value *= 10;
+  }
+  return value;
+}
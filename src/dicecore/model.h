@@ -1,6 +1,7 @@
 #pragma once
 
-#include <pebble.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #define MAX_DICE_GROUPS 8
 #define MAX_DICE_PER_GROUP 64
@@ -46,6 +47,7 @@ const char *model_get_selected_label(const DiceModel *model);
 int model_get_selected_die_index(const DiceModel *model);
 
 bool model_commit_group(DiceModel *model);
+bool model_add_group(DiceModel *model, DiceKind kind, int count);
 void model_clear_groups(DiceModel *model);
 bool model_has_groups(const DiceModel *model);
 
@@ -56,6 +58,8 @@ int model_current_roll_range(const DiceModel *model);
 void model_commit_roll_result(DiceModel *model, int value);
 int model_roll_completed_dice(const DiceModel *model);
 int model_roll_total_dice(const DiceModel *model);
+// Grand total of every committed result across all groups.
+int model_roll_total(const DiceModel *model);
 
 int model_group_count(const DiceModel *model);
 const DiceGroup *model_get_group(const DiceModel *model, int index);
@@ -65,6 +69,10 @@ int model_group_sides(const DiceGroup *group);
 void model_reset_selection_count(DiceModel *model);
 const char *model_current_roll_label(const DiceModel *model);
 DiceKind model_current_roll_kind(const DiceModel *model);
+const char *model_kind_label(DiceKind kind);
 int model_kind_roll_sides(DiceKind kind);
 bool model_kind_zero_based(DiceKind kind);
 bool model_kind_tens_mode(DiceKind kind);
+// Face value of a raw 1..roll_sides draw: zero-based kinds start at 0 and tens
+// dice count in tens (a d100 shows 00-90). 0 for a raw value <= 0.
+int model_kind_face_value(DiceKind kind, int raw_value);
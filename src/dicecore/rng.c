@@ -0,0 +1,103 @@
+#include "rng.h"
+
+// -----------------------------------------------------------------------------
+// RNG MODULE
+// -----------------------------------------------------------------------------
+// xoshiro128** (Blackman & Vigna) plus Lemire's multiply-shift range
+// reduction. Kept free of pebble.h so the exact same generator can run off the
+// watch. The global instance is reseeded from the entropy pool (entropy.c);
+// reseeding mixes new entropy in rather than replacing the state, so a weak
+// harvest can never make the stream worse.
+
+static RngState s_global = {
+  .s = {0x9E3779B9u, 0x243F6A88u, 0xB7E15162u, 0x8AED2A6Bu},
+};
+
+static inline uint32_t prv_rotl(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+void rng_seed(RngState *rng, const uint32_t seed[4]) {
+  bool all_zero = true;
+  for (int i = 0; i < 4; ++i) {
+    rng->s[i] = seed[i];
+    all_zero = all_zero && seed[i] == 0;
+  }
+  // The all-zero state is the one state xoshiro never leaves.
+  if (all_zero) {
+    rng->s[0] = 0x9E3779B9u;
+  }
+}
+
+uint32_t rng_next(RngState *rng) {
+  uint32_t *s = rng->s;
+  const uint32_t result = prv_rotl(s[1] * 5, 7) * 9;
+  const uint32_t t = s[1] << 9;
+
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = prv_rotl(s[3], 11);
+
+  return result;
+}
+
+uint32_t rng_bounded(RngState *rng, uint32_t range) {
+  if (range == 0) {
+    return 0;
+  }
+  uint64_t m = (uint64_t)rng_next(rng) * range;
+  uint32_t low = (uint32_t)m;
+  if (low < range) {
+    // Reject the few values that would over-represent the low faces.
+    const uint32_t threshold = (0u - range) % range;
+    while (low < threshold) {
+      m = (uint64_t)rng_next(rng) * range;
+      low = (uint32_t)m;
+    }
+  }
+  return (uint32_t)(m >> 32);
+}
+
+void rng_jump(RngState *rng) {
+  static const uint32_t s_jump[4] = {0x8764000bu, 0xf542d2d3u, 0x6fa035c3u, 0x77f2db5bu};
+  uint32_t s[4] = {0, 0, 0, 0};
+  for (int i = 0; i < 4; ++i) {
+    for (int b = 0; b < 32; ++b) {
+      if (s_jump[i] & (1u << b)) {
+        for (int w = 0; w < 4; ++w) {
+          s[w] ^= rng->s[w];
+        }
+      }
+      rng_next(rng);
+    }
+  }
+  for (int w = 0; w < 4; ++w) {
+    rng->s[w] = s[w];
+  }
+}
+
+void rng_reseed(const uint32_t entropy[4]) {
+  uint32_t mixed[4];
+  for (int i = 0; i < 4; ++i) {
+    mixed[i] = s_global.s[i] ^ entropy[i];
+  }
+  rng_seed(&s_global, mixed);
+  // Let the new bits diffuse through the whole state before anyone draws.
+  for (int i = 0; i < 8; ++i) {
+    rng_next(&s_global);
+  }
+}
+
+uint32_t rng_global_bounded(uint32_t range) {
+  return rng_bounded(&s_global, range);
+}
+
+int rng_roll(int sides) {
+  if (sides <= 0) {
+    return 0;
+  }
+  return (int)rng_bounded(&s_global, (uint32_t)sides) + 1;
+}
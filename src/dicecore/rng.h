@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// xoshiro128** generator. Small (16 bytes of state), fast on 32-bit cores, and
+// unlike rand() it can be seeded with more than one word of entropy.
+typedef struct {
+  uint32_t s[4];
+} RngState;
+
+void rng_seed(RngState *rng, const uint32_t seed[4]);
+uint32_t rng_next(RngState *rng);
+// Uniform in [0, range) without modulo bias. Returns 0 when range is 0.
+uint32_t rng_bounded(RngState *rng, uint32_t range);
+// Advances the state by 2^64 draws. Seeding N generators alike and jumping the
+// i-th one i times gives N streams that can't overlap in any practical run.
+void rng_jump(RngState *rng);
+
+// App-wide generator used by the roll code.
+void rng_reseed(const uint32_t entropy[4]);
+uint32_t rng_global_bounded(uint32_t range);
+// 1..sides, or 0 when sides <= 0.
+int rng_roll(int sides);
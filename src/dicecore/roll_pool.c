@@ -0,0 +1,57 @@
+#include "roll_pool.h"
+
+#include <string.h>
+
+#include "rng.h"
+
+// -----------------------------------------------------------------------------
+// ROLL POOL MODULE
+// -----------------------------------------------------------------------------
+// Pre-generated bounded values for the active die range. The state machine
+// primes the pool when a group starts rolling and tops it up in idle slices
+// between animation frames, so building a batch's timelines is mostly byte
+// pops. Values fit a byte because the widest range is d% (1..100). Pebble-free
+// so it can be benchmarked on the host (bench/roll_pool_bench.c).
+
+static RollPool s_default_pool;
+
+void roll_pool_reset(RollPool *pool, int range) {
+  memset(pool, 0, sizeof(*pool));
+  pool->range = (range > 0 && range <= UINT8_MAX) ? range : 0;
+}
+
+int roll_pool_fill(RollPool *pool, int max_count) {
+  if (pool->range <= 0) {
+    return 0;
+  }
+  int added = 0;
+  while (added < max_count && pool->level < ROLL_POOL_CAPACITY) {
+    const int tail = (pool->head + pool->level) % ROLL_POOL_CAPACITY;
+    pool->values[tail] = (uint8_t)rng_roll(pool->range);
+    pool->level++;
+    added++;
+  }
+  return added;
+}
+
+bool roll_pool_is_full(const RollPool *pool) {
+  return pool->range <= 0 || pool->level >= ROLL_POOL_CAPACITY;
+}
+
+int roll_pool_take(RollPool *pool, int range) {
+  if (!pool || range != pool->range || pool->level == 0) {
+    if (pool) {
+      pool->misses++;
+    }
+    return rng_roll(range);
+  }
+  const int value = pool->values[pool->head];
+  pool->head = (pool->head + 1) % ROLL_POOL_CAPACITY;
+  pool->level--;
+  pool->hits++;
+  return value;
+}
+
+RollPool *roll_pool_default(void) {
+  return &s_default_pool;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define ROLL_POOL_CAPACITY 256
+
+// Ring buffer of pre-drawn 1..range values for the die range currently being
+// rolled, so the hot path pops a byte instead of running the generator.
+typedef struct {
+  uint8_t values[ROLL_POOL_CAPACITY];
+  uint16_t head;
+  uint16_t level;
+  int range;
+  uint32_t hits;
+  uint32_t misses;
+} RollPool;
+
+void roll_pool_reset(RollPool *pool, int range);
+// Draws at most `max_count` values; returns how many were added.
+int roll_pool_fill(RollPool *pool, int max_count);
+bool roll_pool_is_full(const RollPool *pool);
+// Pops a value for `range`; draws directly when empty or the range differs.
+int roll_pool_take(RollPool *pool, int range);
+
+// The app-wide pool the roll code shares.
+RollPool *roll_pool_default(void);
@@ -0,0 +1,78 @@
+#include "entropy.h"
+
+#include <string.h>
+
+#include "dicecore/rng.h"
+
+// -----------------------------------------------------------------------------
+// ENTROPY MODULE
+// -----------------------------------------------------------------------------
+// A 128-bit pool fed from cheap, already-available sources: millisecond jitter
+// of button presses and taps, and accelerometer samples (whatever the shake
+// detector already receives, plus one peeked reading per roll). Each roll
+// reseeds the generator from the pool, so two watches launched in the same
+// second still diverge as soon as anyone touches them.
+
+#define ENTROPY_LANES 4
+
+typedef struct {
+  uint32_t lanes[ENTROPY_LANES];
+  uint32_t count;
+} EntropyPool;
+
+static EntropyPool s_pool;
+
+// Murmur-style finalizer: every input bit affects every output bit.
+static uint32_t prv_mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7FEB352Du;
+  x ^= x >> 15;
+  x *= 0x846CA68Bu;
+  x ^= x >> 16;
+  return x;
+}
+
+void entropy_add(uint32_t sample) {
+  const int lane = s_pool.count++ % ENTROPY_LANES;
+  const int neighbour = (lane + 1) % ENTROPY_LANES;
+  s_pool.lanes[lane] = prv_mix32(s_pool.lanes[lane] ^ sample ^ s_pool.count) + s_pool.lanes[neighbour];
+}
+
+void entropy_add_accel(const AccelData *data) {
+  if (!data) {
+    return;
+  }
+  // The low bits of each axis are sensor noise even when the watch is still.
+  entropy_add(((uint32_t)(uint16_t)data->x << 16) ^ ((uint32_t)(uint16_t)data->y << 8) ^ (uint16_t)data->z);
+  entropy_add((uint32_t)data->timestamp);
+}
+
+void entropy_add_time_jitter(void) {
+  time_t seconds = 0;
+  uint16_t millis = 0;
+  time_ms(&seconds, &millis);
+  entropy_add(((uint32_t)seconds << 10) ^ millis);
+}
+
+static void prv_add_accel_peek(void) {
+  AccelData data;
+  // Peeking fails while the data service is subscribed; the shake detector
+  // feeds the pool in that case.
+  if (accel_service_peek(&data) == 0) {
+    entropy_add_accel(&data);
+  }
+}
+
+void entropy_init(void) {
+  memset(&s_pool, 0, sizeof(s_pool));
+  entropy_add((uint32_t)time(NULL));
+  entropy_add_time_jitter();
+  prv_add_accel_peek();
+  rng_reseed(s_pool.lanes);
+}
+
+void entropy_reseed_for_roll(void) {
+  entropy_add_time_jitter();
+  prv_add_accel_peek();
+  rng_reseed(s_pool.lanes);
+}
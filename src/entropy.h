@@ -0,0 +1,15 @@
+#pragma once
+
+#include <pebble.h>
+
+void entropy_init(void);
+
+void entropy_add(uint32_t sample);
+void entropy_add_accel(const AccelData *data);
+// Mixes in the current millisecond; call on user input, where the timing
+// jitter is what carries the entropy.
+void entropy_add_time_jitter(void);
+
+// Takes a fresh accelerometer reading and reseeds the roll generator from the
+// pool. Meant to be called once per roll.
+void entropy_reseed_for_roll(void);
@@ -0,0 +1,72 @@
+#include "frame.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// FRAME MODULE
+// -----------------------------------------------------------------------------
+// Record framing for message bodies that carry a run of records. Each record
+// travels as
+//
+//   [length:1-2][record...][crc8]
+//
+// where the length is little-endian base-128 (one byte below 128, two up to
+// FRAME_RECORD_MAX) and the CRC covers the length bytes and the record. Frames
+// are self-contained, so msg_queue can concatenate them freely, and a body of
+// any number of records still costs one tuple header instead of one per
+// value. The phone-side decoder is src/js/frame.js.
+//
+// Safe tweaks:
+// - Changing the layout means changing src/js/frame.js in step.
+
+#define FRAME_CRC8_POLY 0x07
+
+uint8_t frame_crc8(uint8_t crc, const uint8_t *data, uint16_t length) {
+  for (uint16_t i = 0; i < length; ++i) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ FRAME_CRC8_POLY) : (uint8_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+static uint16_t prv_length_size(uint16_t length) {
+  return (length < 0x80) ? 1 : 2;
+}
+
+uint16_t frame_encode(const uint8_t *record, uint16_t length, uint8_t *out, uint16_t size) {
+  const uint16_t prefix = prv_length_size(length);
+  if (length > FRAME_RECORD_MAX || (uint32_t)prefix + length + 1 > size) {
+    return 0;
+  }
+  if (prefix == 1) {
+    out[0] = (uint8_t)length;
+  } else {
+    out[0] = (uint8_t)(0x80 | (length & 0x7F));
+    out[1] = (uint8_t)(length >> 7);
+  }
+  if (length > 0) {
+    memmove(&out[prefix], record, length);
+  }
+  out[prefix + length] = frame_crc8(0, out, prefix + length);
+  return prefix + length + 1;
+}
+
+uint16_t frame_decode(const uint8_t *data, uint16_t size, const uint8_t **record, uint16_t *record_length) {
+  if (size < 2) {
+    return 0;
+  }
+  uint16_t prefix = 1;
+  uint16_t length = data[0];
+  if (length & 0x80) {
+    prefix = 2;
+    length = (length & 0x7F) | ((uint16_t)data[1] << 7);
+  }
+  if ((uint32_t)prefix + length + 1 > size || frame_crc8(0, data, prefix + length) != data[prefix + length]) {
+    return 0;
+  }
+  *record = &data[prefix];
+  *record_length = length;
+  return prefix + length + 1;
+}
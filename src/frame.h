@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Worst-case bytes a frame adds around its record: 2 length bytes + 1 CRC.
+#define FRAME_OVERHEAD_MAX 3
+// Longest record a frame can carry (two 7-bit length groups).
+#define FRAME_RECORD_MAX 0x3FFF
+
+// Wraps `record` as one frame in `out`. Returns the frame length, or 0 if the
+// record is too long or `out` is too small. `record` may overlap `out`, so a
+// record built at out + 2 can be framed in place.
+uint16_t frame_encode(const uint8_t *record, uint16_t length, uint8_t *out, uint16_t size);
+
+// Reads the frame at the start of `data`. On success points `record` into
+// `data` and returns the whole frame's length; returns 0 if the frame is
+// truncated or its CRC does not match.
+uint16_t frame_decode(const uint8_t *data, uint16_t size, const uint8_t **record, uint16_t *record_length);
+
+// CRC-8 (polynomial 0x07, init 0), as used by frame_encode.
+uint8_t frame_crc8(uint8_t crc, const uint8_t *data, uint16_t length);
@@ -0,0 +1,246 @@
+#include "history.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "comm.h"
+#include "msg_queue.h"
+#include "sched.h"
+
+// -----------------------------------------------------------------------------
+// HISTORY MODULE
+// -----------------------------------------------------------------------------
+// Browses the roll history that PebbleKit JS keeps in localStorage, so the
+// watch never spends persist storage on it. Only a few pages of
+// HISTORY_PAGE_SIZE entries are held at once; the page under the cursor is
+// fetched first, then the next one is prefetched so scrolling rarely waits on
+// the radio.
+//
+// Requests and pages (history_request/history_page) are defined in
+// protocol/dice_protocol.json; index 0 is the newest roll. A page's entries
+// are packed as [seq:2][total:2][group count] + [kind][count]..., little-endian.
+//
+// Safe tweaks:
+// - HISTORY_PAGE_SIZE (history.h) trades message size for round trips.
+// - HISTORY_PAGE_SLOTS keeps more pages around for scrolling back.
+
+#define HISTORY_PAGE_SLOTS 3
+#define HISTORY_REQUEST_TIMEOUT_MS 5000
+#define HISTORY_ENTRY_HEADER 5
+
+typedef struct {
+  int page;
+  int entry_count;
+  HistoryEntry entries[HISTORY_PAGE_SIZE];
+} HistoryPage;
+
+typedef struct {
+  HistoryPage pages[HISTORY_PAGE_SLOTS];
+  int total;
+  int cursor;
+  int requested_page;
+  bool open;
+  SchedTimer *timeout_timer;
+  HistoryReadyHandler on_ready;
+  void *ready_context;
+} HistoryState;
+
+static HistoryState s_history;
+
+static void prv_pump(void);
+
+static void prv_clear_pages(void) {
+  for (int i = 0; i < HISTORY_PAGE_SLOTS; ++i) {
+    s_history.pages[i].page = -1;
+    s_history.pages[i].entry_count = 0;
+  }
+}
+
+static HistoryPage *prv_find_page(int page) {
+  for (int i = 0; i < HISTORY_PAGE_SLOTS; ++i) {
+    if (s_history.pages[i].page == page) {
+      return &s_history.pages[i];
+    }
+  }
+  return NULL;
+}
+
+// Reuses the cached page farthest from the cursor.
+static HistoryPage *prv_page_slot(void) {
+  const int cursor_page = s_history.cursor / HISTORY_PAGE_SIZE;
+  HistoryPage *best = &s_history.pages[0];
+  int best_distance = -1;
+  for (int i = 0; i < HISTORY_PAGE_SLOTS; ++i) {
+    HistoryPage *page = &s_history.pages[i];
+    if (page->page < 0) {
+      return page;
+    }
+    const int distance = abs(page->page - cursor_page);
+    if (distance > best_distance) {
+      best = page;
+      best_distance = distance;
+    }
+  }
+  return best;
+}
+
+static void prv_cancel_timeout(void) {
+  if (s_history.timeout_timer) {
+    sched_timer_cancel(s_history.timeout_timer);
+    s_history.timeout_timer = NULL;
+  }
+}
+
+static void prv_timeout_cb(void *data) {
+  s_history.timeout_timer = NULL;
+  s_history.requested_page = -1;
+  prv_pump();
+}
+
+static void prv_request_page(int page) {
+  const ProtoHistoryRequest msg = {.first = page * HISTORY_PAGE_SIZE, .count = HISTORY_PAGE_SIZE};
+  uint8_t request[PROTO_HISTORY_REQUEST_FIXED_SIZE];
+  const uint16_t size = proto_history_request_pack(&msg, request, sizeof(request));
+  if (!msg_queue_push(PROTO_MSG_HISTORY_REQUEST, request, size, 0)) {
+    return;
+  }
+  s_history.requested_page = page;
+  s_history.timeout_timer = sched_timer_register(HISTORY_REQUEST_TIMEOUT_MS, prv_timeout_cb, NULL);
+}
+
+static bool prv_page_exists(int page) {
+  return page >= 0 && (s_history.total < 0 || page * HISTORY_PAGE_SIZE < s_history.total);
+}
+
+// One request in flight at a time: the cursor's page, then the next one.
+static void prv_pump(void) {
+  if (!s_history.open || s_history.requested_page >= 0) {
+    return;
+  }
+  const int cursor_page = s_history.cursor / HISTORY_PAGE_SIZE;
+  if (!prv_find_page(cursor_page)) {
+    prv_request_page(cursor_page);
+  } else if (prv_page_exists(cursor_page + 1) && !prv_find_page(cursor_page + 1)) {
+    prv_request_page(cursor_page + 1);
+  }
+}
+
+static uint16_t prv_read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// Decodes the entries of one page; stops at the first truncated entry.
+static int prv_decode_entries(const uint8_t *data, int length, int count, HistoryEntry *out) {
+  int offset = 0;
+  int decoded = 0;
+  while (decoded < count && decoded < HISTORY_PAGE_SIZE && offset + HISTORY_ENTRY_HEADER <= length) {
+    HistoryEntry *entry = &out[decoded];
+    entry->seq = prv_read_u16(&data[offset]);
+    entry->total = prv_read_u16(&data[offset + 2]);
+    const int groups = data[offset + 4];
+    offset += HISTORY_ENTRY_HEADER;
+    if (groups > MAX_DICE_GROUPS || offset + groups * 2 > length) {
+      break;
+    }
+    entry->group_count = (uint8_t)groups;
+    for (int g = 0; g < groups; ++g) {
+      entry->kinds[g] = data[offset++];
+      entry->counts[g] = data[offset++];
+    }
+    ++decoded;
+  }
+  return decoded;
+}
+
+static void prv_page_received(const uint8_t *body, uint16_t length, void *context) {
+  ProtoHistoryPage reply;
+  if (!s_history.open || !proto_history_page_unpack(body, length, &reply)) {
+    return;
+  }
+  const int page_index = reply.first / HISTORY_PAGE_SIZE;
+  s_history.total = reply.total;
+  if (page_index == s_history.requested_page) {
+    prv_cancel_timeout();
+    s_history.requested_page = -1;
+  }
+
+  HistoryPage *page = prv_find_page(page_index);
+  if (!page) {
+    page = prv_page_slot();
+  }
+  page->page = page_index;
+  page->entry_count = prv_decode_entries(reply.entries, reply.entries_length, reply.entry_count, page->entries);
+
+  if (s_history.cursor >= s_history.total && s_history.total > 0) {
+    s_history.cursor = s_history.total - 1;
+  }
+  prv_pump();
+  if (s_history.on_ready) {
+    s_history.on_ready(s_history.ready_context);
+  }
+}
+
+void history_init(HistoryReadyHandler on_ready, void *context) {
+  memset(&s_history, 0, sizeof(s_history));
+  s_history.on_ready = on_ready;
+  s_history.ready_context = context;
+  s_history.total = -1;
+  s_history.requested_page = -1;
+  prv_clear_pages();
+  comm_subscribe(PROTO_MSG_HISTORY_PAGE, prv_page_received, NULL);
+}
+
+void history_deinit(void) {
+  history_close();
+  s_history.on_ready = NULL;
+}
+
+void history_open(void) {
+  // The phone's log may have grown since last time; start from scratch.
+  prv_cancel_timeout();
+  prv_clear_pages();
+  s_history.total = -1;
+  s_history.cursor = 0;
+  s_history.requested_page = -1;
+  s_history.open = true;
+  prv_pump();
+}
+
+void history_close(void) {
+  prv_cancel_timeout();
+  s_history.open = false;
+  s_history.requested_page = -1;
+}
+
+int history_count(void) {
+  return s_history.total;
+}
+
+int history_cursor(void) {
+  return s_history.cursor;
+}
+
+bool history_move(int delta) {
+  int cursor = s_history.cursor + delta;
+  if (s_history.total >= 0 && cursor > s_history.total - 1) {
+    cursor = s_history.total - 1;
+  }
+  if (cursor < 0) {
+    cursor = 0;
+  }
+  if (cursor == s_history.cursor) {
+    return false;
+  }
+  s_history.cursor = cursor;
+  prv_pump();
+  return true;
+}
+
+const HistoryEntry *history_current(void) {
+  const HistoryPage *page = prv_find_page(s_history.cursor / HISTORY_PAGE_SIZE);
+  if (!page) {
+    return NULL;
+  }
+  const int index = s_history.cursor % HISTORY_PAGE_SIZE;
+  return (index < page->entry_count) ? &page->entries[index] : NULL;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "dicecore/model.h"
+
+#define HISTORY_PAGE_SIZE 6
+
+typedef void (*HistoryReadyHandler)(void *context);
+
+// One past roll as the phone summarizes it: what was rolled and its total.
+typedef struct {
+  uint16_t seq;
+  uint16_t total;
+  uint8_t group_count;
+  uint8_t kinds[MAX_DICE_GROUPS];
+  uint8_t counts[MAX_DICE_GROUPS];
+} HistoryEntry;
+
+// `on_ready` runs whenever a requested page arrives from the phone.
+void history_init(HistoryReadyHandler on_ready, void *context);
+void history_deinit(void);
+
+// Starts browsing at the newest roll; close stops fetching.
+void history_open(void);
+void history_close(void);
+
+// Number of rolls the phone holds, or -1 until the first page arrives.
+int history_count(void);
+int history_cursor(void);
+// Moves the cursor (0 = newest); returns true when it moved.
+bool history_move(int delta);
+// Entry under the cursor, or NULL while its page is still on the way.
+const HistoryEntry *history_current(void);
@@ -1,45 +1,887 @@
-Pebble.addEventListener('ready', function(e) {
-  Pebble.sendAppMessage({'APP_READY': true});
-});
+// -----------------------------------------------------------------------------
+// PHONE SIDE
+// -----------------------------------------------------------------------------
+// Receives packed roll records from the watch (see src/roll_log.c for the
+// byte layout) and keeps them in localStorage, serving them back a page at a
+// time (src/history.c). Also computes total-roll distributions for pools too
+// large for the watch (src/odds.c), hosts the settings page for presets and
+// roll profiles (src/config_sync.c), can forward rolls to a scoreboard
+// server over HTTP, and relays a shared table feed (src/table_feed.c).
+//
+// Every message is one PAYLOAD byte array; protocol.js (generated from
+// protocol/dice_protocol.json by tools/protocol_gen.py) frames and parses it.
+
+var frame = require('./frame');
+var protocol = require('./protocol');
+
+var DICE_KINDS = ['d4', 'd6', 'd8', 'd10', 'd12', 'd20', 'd100', 'd%'];
+var ROLL_LOG_STORAGE_KEY = 'rollLog';
+var ROLL_LOG_CHUNK_SIZE = 100;
+var ODDS_CDF_POINTS = 32;
+var CONFIG_STORAGE_KEY = 'config';
+var CONFIG_SYNCED_KEY = 'configSynced';
+var PRESET_MAX = 8;
+var PRESET_NAME_LENGTH = 15;
+var PRESET_DELETE = 0xFF;
+var MAX_DICE_GROUPS = 8;
+var MAX_DICE_PER_GROUP = 64;
 
-Pebble.addEventListener('appmessage', function(dict) {
-  if(dict.payload['LOCK_UUID'] && dict.payload['ACCESS_TOKEN']) {
-    toggleLockitronState(dict.payload['LOCK_UUID'], dict.payload['ACCESS_TOKEN']);
+// Animated profiles by RollProfileId, with the defaults from
+// src/roll_profile.c.
+var PROFILES = [
+  {id: 1, name: 'fast', defaults: {spinMs: 380, ticksMin: 7, ticksMax: 8, finalHoldMs: 120, resultHoldMs: 300}},
+  {id: 2, name: 'classic', defaults: {spinMs: 3000, ticksMin: 29, ticksMax: 30, finalHoldMs: 350, resultHoldMs: 1000}}
+];
+var PROFILE_FIELDS = ['spinMs', 'ticksMin', 'ticksMax', 'finalHoldMs', 'resultHoldMs'];
+var EXPORT_QUEUE_KEY = 'exportQueue';
+var EXPORT_QUEUE_LIMIT = 5000;
+var EXPORT_BATCH_MAX = 500;
+var EXPORT_DEFAULTS = {url: '', format: 'json', intervalSec: 30};
+var TABLE_FEED_CAPACITY = 16;
+var TABLE_NAME_LENGTH = 11;
+var TABLE_POST_DELAY_MS = 1000;
+var TABLE_POLL_MS = 3000;
+var TABLE_RETRY_MS = 1000;
+var TABLE_PENDING_LIMIT = 200;
+var TABLE_SEEN_LIMIT = 1000;
+// Stays inside the watch's 512-byte inbox with the dictionary and id headers.
+var TABLE_BODY_MAX = 480;
+
+// Face values per kind as offset + stride * k, k in [0, sides). Mirrors the
+// die definitions in src/dicecore/model.c.
+var DICE_FACES = [
+  {offset: 1, stride: 1, sides: 4},
+  {offset: 1, stride: 1, sides: 6},
+  {offset: 1, stride: 1, sides: 8},
+  {offset: 1, stride: 1, sides: 10},
+  {offset: 1, stride: 1, sides: 12},
+  {offset: 1, stride: 1, sides: 20},
+  {offset: 0, stride: 10, sides: 10},
+  {offset: 0, stride: 1, sides: 100}
+];
+
+// Parses one roll record (layout in src/roll_log.c); null if it is truncated.
+function decodeRollRecord(bytes) {
+  if (bytes.length < 3) {
+    return null;
   }
-});
+  var roll = {
+    seq: bytes[0] | (bytes[1] << 8),
+    receivedAt: Date.now(),
+    groups: []
+  };
+  var groupCount = bytes[2];
+  var offset = 3;
+  for (var g = 0; g < groupCount; g++) {
+    if (offset + 2 > bytes.length) {
+      return null;
+    }
+    var kind = bytes[offset];
+    var count = bytes[offset + 1];
+    offset += 2;
+    if (offset + count > bytes.length) {
+      return null;
+    }
+    roll.groups.push({
+      kind: DICE_KINDS[kind] || ('?' + kind),
+      results: bytes.slice(offset, offset + count)
+    });
+    offset += count;
+  }
+  return roll;
+}
 
-function toggleLockitronState(lock_uuid, access_token) {
-  var url = 'https://api.lockitron.com/v2/locks/' + lock_uuid +
-              '?access_token=' + access_token;
-  var json = {'state': 'toggle'};
+// Splits the framed records of a rollLog message (see src/frame.c) into roll
+// objects. Stops at the first corrupt frame rather than guessing.
+function decodeRollLog(bytes) {
+  var unframed = frame.decode(bytes);
+  if (unframed.dropped > 0) {
+    console.log('Dropped ' + unframed.dropped + ' byte(s) of a corrupt roll log');
+  }
+  var rolls = [];
+  for (var i = 0; i < unframed.records.length; i++) {
+    var roll = decodeRollRecord(unframed.records[i]);
+    if (roll) {
+      rolls.push(roll);
+    }
+  }
+  return rolls;
+}
+
+// The history is unbounded, so it lives in chunks of ROLL_LOG_CHUNK_SIZE rolls
+// ('rollLog.<n>') plus a small index ('rollLog.meta' = {start, end} absolute
+// roll numbers). Appending touches only the newest chunk and a page read only
+// the chunks it overlaps. When storage fills up, the oldest chunk goes.
+// A chunk and the meta are written together, so meta.end is the truth: rolls
+// past it in a chunk are leftovers of a failed write and get overwritten.
+function loadRollMeta() {
+  try {
+    return JSON.parse(localStorage.getItem(ROLL_LOG_STORAGE_KEY + '.meta')) || {start: 0, end: 0};
+  } catch (e) {
+    return {start: 0, end: 0};
+  }
+}
 
-  xhrWrapper(url, 'put', json, function(req) {
-    if(req.status == 200) {
-      sendResultToPebble(JSON.parse(req.response));
+function loadRollChunk(chunk) {
+  try {
+    return JSON.parse(localStorage.getItem(ROLL_LOG_STORAGE_KEY + '.' + chunk)) || [];
+  } catch (e) {
+    return [];
+  }
+}
+
+function saveRollChunk(meta, chunk, rolls) {
+  for (;;) {
+    try {
+      localStorage.setItem(ROLL_LOG_STORAGE_KEY + '.' + chunk, JSON.stringify(rolls));
+      localStorage.setItem(ROLL_LOG_STORAGE_KEY + '.meta', JSON.stringify(meta));
+      return;
+    } catch (e) {
+      var oldest = Math.floor(meta.start / ROLL_LOG_CHUNK_SIZE);
+      if (oldest >= chunk) {
+        throw e;
+      }
+      localStorage.removeItem(ROLL_LOG_STORAGE_KEY + '.' + oldest);
+      meta.start = (oldest + 1) * ROLL_LOG_CHUNK_SIZE;
     }
+  }
+}
+
+// Returns false if storage was too full to keep them, even after dropping
+// every older chunk; whatever was written before that stays consistent.
+function storeRolls(rolls) {
+  var meta = loadRollMeta();
+  var chunk = Math.floor(meta.end / ROLL_LOG_CHUNK_SIZE);
+  var pending = loadRollChunk(chunk).slice(0, meta.end % ROLL_LOG_CHUNK_SIZE);
+  try {
+    rolls.forEach(function(roll) {
+      pending.push(roll);
+      meta.end++;
+      if (meta.end % ROLL_LOG_CHUNK_SIZE === 0) {
+        saveRollChunk(meta, chunk, pending);
+        chunk++;
+        pending = [];
+      }
+    });
+    if (pending.length > 0) {
+      saveRollChunk(meta, chunk, pending);
+    }
+    return true;
+  } catch (e) {
+    console.log('Roll log storage full; could not keep all ' + rolls.length + ' roll(s): ' + e);
+    return false;
+  }
+}
+
+// Rolls newest-first: index 0 is the latest roll.
+function readRolls(first, count) {
+  var meta = loadRollMeta();
+  var rolls = [];
+  var chunks = {};
+  for (var i = first; i < first + count; i++) {
+    var absolute = meta.end - 1 - i;
+    if (absolute < meta.start) {
+      break;
+    }
+    var chunk = Math.floor(absolute / ROLL_LOG_CHUNK_SIZE);
+    if (!chunks[chunk]) {
+      chunks[chunk] = loadRollChunk(chunk);
+    }
+    var roll = chunks[chunk][absolute % ROLL_LOG_CHUNK_SIZE];
+    if (roll) {
+      rolls.push(roll);
+    }
+  }
+  return {rolls: rolls, total: meta.end - meta.start};
+}
+
+// Older builds kept everything in a single 'rollLog' array.
+function migrateRollLog() {
+  var legacy = localStorage.getItem(ROLL_LOG_STORAGE_KEY);
+  if (legacy === null) {
+    return;
+  }
+  try {
+    storeRolls(JSON.parse(legacy) || []);
+  } catch (e) {
+    console.log('Dropping unreadable roll log');
+  }
+  localStorage.removeItem(ROLL_LOG_STORAGE_KEY);
+}
+
+function sendMessage(name, fields, onAck, onNack) {
+  var message = {};
+  message[protocol.MESSAGE_KEY] = protocol.encode(name, fields);
+  Pebble.sendAppMessage(message, onAck, onNack);
+}
+
+// Replies with a historyPage whose entries use the layout documented in
+// src/history.c.
+function answerHistoryRequest(request) {
+  var page = readRolls(request.first, request.count);
+  var entries = [];
+  page.rolls.forEach(function(roll) {
+    var total = 0;
+    roll.groups.forEach(function(group) {
+      for (var r = 0; r < group.results.length; r++) {
+        total += group.results[r];
+      }
+    });
+    pushU16(entries, roll.seq);
+    pushU16(entries, total);
+    entries.push(roll.groups.length);
+    roll.groups.forEach(function(group) {
+      entries.push(Math.max(0, DICE_KINDS.indexOf(group.kind)), group.results.length);
+    });
   });
+  sendMessage('historyPage', {
+    first: request.first,
+    total: Math.min(page.total, 0xFFFF),
+    entryCount: page.rolls.length,
+    entries: entries
+  });
+}
 
+// Exact distribution of the grand total. Each die is folded in with a
+// stride-wise prefix sum, so the cost is linear in the number of sums per die
+// instead of multiplying by its face count.
+function totalDistribution(groups) {
+  var min = 0;
+  var dist = new Float64Array([1]);
+  groups.forEach(function(group) {
+    var faces = DICE_FACES[group.kind];
+    for (var d = 0; d < group.count; d++) {
+      var width = faces.stride * faces.sides;
+      var length = dist.length + faces.stride * (faces.sides - 1);
+      var prefix = new Float64Array(length);
+      var next = new Float64Array(length);
+      for (var r = 0; r < length; r++) {
+        prefix[r] = (r < dist.length ? dist[r] : 0) + (r >= faces.stride ? prefix[r - faces.stride] : 0);
+        next[r] = (prefix[r] - (r >= width ? prefix[r - width] : 0)) / faces.sides;
+      }
+      dist = next;
+      min += faces.offset;
+    }
+  });
+  return {min: min, dist: dist};
 }
 
-function sendResultToPebble(json) {
-  if(json.state) {
-    var lockState = json.state == 'lock' ? 1 : 0;
-    Pebble.sendAppMessage({
-      'LOCK_STATE': lockState
+// Same sampling as prv_point_offset() in src/odds.c, but only across the
+// window where the CDF visibly moves: with hundreds of dice almost all of the
+// full range rounds to 0 or 65535 and would waste the points.
+function downsampleCdf(dist) {
+  var cumulative = new Float64Array(dist.length);
+  var running = 0;
+  for (var r = 0; r < dist.length; r++) {
+    running += dist[r];
+    cumulative[r] = running;
+  }
+  var lo = 0;
+  while (lo < dist.length - 1 && cumulative[lo] * 65535 < 0.5) {
+    lo++;
+  }
+  var hi = lo;
+  while (hi < dist.length - 1 && cumulative[hi] * 65535 < 65534.5) {
+    hi++;
+  }
+
+  var points = [];
+  for (var i = 0; i < ODDS_CDF_POINTS; i++) {
+    var at = lo + Math.floor((i * (hi - lo)) / (ODDS_CDF_POINTS - 1));
+    points.push(Math.min(65535, Math.round(cumulative[at] * 65535)));
+  }
+  return {lo: lo, hi: hi, points: points};
+}
+
+function pushU16(bytes, value) {
+  bytes.push(value & 0xFF, (value >> 8) & 0xFF);
+}
+
+// The request's groups are [kind][count] pairs.
+function answerOddsRequest(request) {
+  var groups = [];
+  for (var g = 0; g < request.groupCount && g * 2 + 1 < request.groups.length; g++) {
+    var kind = request.groups[g * 2];
+    if (!DICE_FACES[kind]) {
+      return;
+    }
+    groups.push({kind: kind, count: request.groups[g * 2 + 1]});
+  }
+
+  var result = totalDistribution(groups);
+  var cdf = downsampleCdf(result.dist);
+  sendMessage('oddsReply', {
+    hash: request.hash,
+    minTotal: result.min + cdf.lo,
+    maxTotal: result.min + cdf.hi,
+    cdf: cdf.points
+  });
+}
+
+// ----- Settings ---------------------------------------------------------------
+// The settings page is generated here and opened as a data: URL, so it works
+// offline and ships with the bundle. On save only presets/profiles whose
+// encoded bytes differ from what the watch last acknowledged are sent.
+
+function loadJson(key, fallback) {
+  try {
+    return JSON.parse(localStorage.getItem(key)) || fallback;
+  } catch (e) {
+    return fallback;
+  }
+}
+
+function loadConfig() {
+  var config = loadJson(CONFIG_STORAGE_KEY, {});
+  config.presets = config.presets || [];
+  config.profiles = config.profiles || {};
+  PROFILES.forEach(function(profile) {
+    var stored = config.profiles[profile.name] || {};
+    var merged = {};
+    PROFILE_FIELDS.forEach(function(field) {
+      merged[field] = (stored[field] === undefined) ? profile.defaults[field] : stored[field];
     });
+    config.profiles[profile.name] = merged;
+  });
+  var exportConfig = config.export || {};
+  config.export = {
+    url: exportConfig.url || EXPORT_DEFAULTS.url,
+    format: (exportConfig.format === 'csv') ? 'csv' : 'json',
+    intervalSec: Math.max(1, parseInt(exportConfig.intervalSec, 10) || EXPORT_DEFAULTS.intervalSec)
+  };
+  var tableConfig = config.table || {};
+  config.table = {
+    url: (tableConfig.url || '').replace(/\/+$/, ''),
+    name: tableConfig.name || '',
+    player: (tableConfig.player || '').substring(0, TABLE_NAME_LENGTH)
+  };
+  return config;
+}
+
+// "3d6 + 1d20" -> [{kind: 1, count: 3}, {kind: 5, count: 1}]
+function parseDice(text) {
+  var groups = [];
+  var pattern = /(\d*)\s*(d%|d\d+)/gi;
+  var match;
+  while ((match = pattern.exec(text || '')) && groups.length < MAX_DICE_GROUPS) {
+    var kind = DICE_KINDS.indexOf(match[2].toLowerCase());
+    if (kind < 0) {
+      continue;
+    }
+    var count = Math.min(MAX_DICE_PER_GROUP, Math.max(1, parseInt(match[1], 10) || 1));
+    groups.push({kind: kind, count: count});
+  }
+  return groups;
+}
+
+function clampInt(value, min, max) {
+  return Math.min(max, Math.max(min, parseInt(value, 10) || 0));
+}
+
+// One preset record, see src/config_sync.c.
+function encodePreset(slot, preset) {
+  var groups = preset ? parseDice(preset.dice) : [];
+  if (groups.length === 0) {
+    return [slot, PRESET_DELETE];
+  }
+  var name = (preset.name || ('Preset ' + (slot + 1))).substring(0, PRESET_NAME_LENGTH);
+  var bytes = [slot, groups.length, name.length];
+  for (var i = 0; i < name.length; i++) {
+    bytes.push(name.charCodeAt(i) & 0x7F);
   }
+  groups.forEach(function(group) {
+    bytes.push(group.kind, group.count);
+  });
+  return bytes;
+}
+
+// One profile record, see src/config_sync.c.
+function encodeProfile(profile, timing) {
+  var bytes = [profile.id];
+  var ticksMin = clampInt(timing.ticksMin, 1, 32);
+  pushU16(bytes, clampInt(timing.spinMs, 0, 10000));
+  bytes.push(ticksMin, clampInt(timing.ticksMax, ticksMin, 32));
+  pushU16(bytes, clampInt(timing.finalHoldMs, 0, 10000));
+  pushU16(bytes, clampInt(timing.resultHoldMs, 0, 10000));
+  return bytes;
 }
 
-function xhrWrapper(url, type, data, callback) {
-  var xhr = new XMLHttpRequest();
-  xhr.onload = function () {
-    callback(xhr);
+// Sends whatever differs from the last acknowledged sync. Anything that fails
+// stays "dirty" and goes out with the next save or launch.
+function syncConfig() {
+  var config = loadConfig();
+  var synced = loadJson(CONFIG_SYNCED_KEY, {presets: {}, profiles: {}});
+  var presetBytes = [];
+  var profileBytes = [];
+  var pending = {presets: {}, profiles: {}};
+
+  for (var slot = 0; slot < PRESET_MAX; slot++) {
+    var encoded = encodePreset(slot, config.presets[slot]);
+    var key = encoded.join(',');
+    // Slots that were never synced are empty on the watch already.
+    var known = synced.presets[slot] || [slot, PRESET_DELETE].join(',');
+    if (key !== known) {
+      presetBytes = presetBytes.concat(encoded);
+      pending.presets[slot] = key;
+    }
+  }
+  PROFILES.forEach(function(profile) {
+    var encoded = encodeProfile(profile, config.profiles[profile.name]);
+    var key = encoded.join(',');
+    var known = synced.profiles[profile.id] || encodeProfile(profile, profile.defaults).join(',');
+    if (key !== known) {
+      profileBytes = profileBytes.concat(encoded);
+      pending.profiles[profile.id] = key;
+    }
+  });
+
+  if (presetBytes.length === 0 && profileBytes.length === 0) {
+    return;
+  }
+  // Presets and profiles are separate messages, each acknowledged on its own.
+  // The second waits for the first so the watch's inbox only holds one.
+  var sendProfiles = function() {
+    sendSyncRecords('profile', profileBytes, 'profiles', pending.profiles);
   };
-  xhr.open(type, url);
-  if(data) {
-    xhr.setRequestHeader('Content-Type', 'application/json');
-    xhr.send(JSON.stringify(data));
+  if (presetBytes.length > 0) {
+    sendSyncRecords('preset', presetBytes, 'presets', pending.presets, sendProfiles);
   } else {
-    xhr.send();
+    sendProfiles();
+  }
+}
+
+// Sends one message of changed records and, once the watch acknowledges it,
+// remembers their encodings under `section` of the synced state.
+function sendSyncRecords(name, records, section, pending, done) {
+  if (records.length === 0) {
+    return;
   }
+  sendMessage(name, {records: records}, function() {
+    var latest = loadJson(CONFIG_SYNCED_KEY, {presets: {}, profiles: {}});
+    Object.keys(pending).forEach(function(id) {
+      latest[section][id] = pending[id];
+    });
+    localStorage.setItem(CONFIG_SYNCED_KEY, JSON.stringify(latest));
+    console.log('Synced ' + Object.keys(pending).length + ' ' + section);
+    if (done) {
+      done();
+    }
+  }, function() {
+    console.log('Settings sync failed; will retry');
+    if (done) {
+      done();
+    }
+  });
+}
+
+function escapeHtml(text) {
+  return String(text).replace(/[&<>"']/g, function(c) {
+    return '&#' + c.charCodeAt(0) + ';';
+  });
 }
+
+function buildConfigPage(config) {
+  var html = '<!DOCTYPE html><html><head><meta name="viewport" content="width=device-width">' +
+    '<style>body{font-family:sans-serif;margin:12px}input{width:100%;margin:2px 0 8px}' +
+    'fieldset{margin-bottom:12px}</style></head><body><h2>Dice presets</h2>';
+  for (var slot = 0; slot < PRESET_MAX; slot++) {
+    var preset = config.presets[slot] || {};
+    html += '<fieldset><legend>Preset ' + (slot + 1) + '</legend>' +
+      '<input id="name' + slot + '" maxlength="' + PRESET_NAME_LENGTH + '" placeholder="Name" value="' +
+      escapeHtml(preset.name || '') + '">' +
+      '<input id="dice' + slot + '" placeholder="e.g. 3d6 + 1d20" value="' + escapeHtml(preset.dice || '') +
+      '"></fieldset>';
+  }
+  html += '<h2>Roll profiles</h2>';
+  PROFILES.forEach(function(profile) {
+    html += '<fieldset><legend>' + profile.name + '</legend>';
+    PROFILE_FIELDS.forEach(function(field) {
+      html += field + '<input type="number" id="' + profile.name + '.' + field + '" value="' +
+        config.profiles[profile.name][field] + '">';
+    });
+    html += '</fieldset>';
+  });
+  html += '<h2>Export</h2><fieldset><legend>Scoreboard server</legend>' +
+    'URL<input id="export.url" type="url" placeholder="http://192.168.1.10:8080/rolls" value="' +
+    escapeHtml(config.export.url) + '">Format<select id="export.format">' +
+    '<option value="json"' + (config.export.format === 'json' ? ' selected' : '') + '>JSON</option>' +
+    '<option value="csv"' + (config.export.format === 'csv' ? ' selected' : '') + '>CSV</option></select>' +
+    '<br>Send at most every (s)<input id="export.intervalSec" type="number" min="1" value="' +
+    config.export.intervalSec + '"></fieldset>';
+  html += '<h2>Table</h2><fieldset><legend>Shared table feed</legend>' +
+    'Aggregator URL<input id="table.url" type="url" placeholder="http://192.168.1.10:8090" value="' +
+    escapeHtml(config.table.url) + '">Table<input id="table.name" placeholder="friday" value="' +
+    escapeHtml(config.table.name) + '">Your name<input id="table.player" maxlength="' + TABLE_NAME_LENGTH +
+    '" value="' + escapeHtml(config.table.player) + '"></fieldset>';
+  html += '<button id="save">Save</button><script>' +
+    'var PRESET_MAX=' + PRESET_MAX + ',PROFILES=' + JSON.stringify(PROFILES.map(function(p) { return p.name; })) +
+    ',FIELDS=' + JSON.stringify(PROFILE_FIELDS) + ';' +
+    'document.getElementById("save").onclick=function(){var c={presets:[],profiles:{}};' +
+    'for(var i=0;i<PRESET_MAX;i++){c.presets.push({name:document.getElementById("name"+i).value,' +
+    'dice:document.getElementById("dice"+i).value});}' +
+    'PROFILES.forEach(function(p){c.profiles[p]={};FIELDS.forEach(function(f){' +
+    'c.profiles[p][f]=document.getElementById(p+"."+f).value;});});' +
+    'c.export={};["url","format","intervalSec"].forEach(function(f){' +
+    'c.export[f]=document.getElementById("export."+f).value;});' +
+    'c.table={};["url","name","player"].forEach(function(f){' +
+    'c.table[f]=document.getElementById("table."+f).value;});' +
+    'location.href="pebblejs://close#"+encodeURIComponent(JSON.stringify(c));};' +
+    '</script></body></html>';
+  return 'data:text/html;charset=utf-8,' + encodeURIComponent(html);
+}
+
+// ----- HTTP export ------------------------------------------------------------
+// Rolls bound for the scoreboard wait in localStorage ('exportQueue'), so an
+// offline stretch or an app restart loses nothing. At most one POST goes out
+// per export interval, carrying everything queued (up to EXPORT_BATCH_MAX), to
+// keep radio wakeups down. Failed posts are retried at the next interval.
+
+var s_export = {timer: null, inFlight: false, lastAt: 0};
+
+function rollTotal(roll) {
+  var total = 0;
+  roll.groups.forEach(function(group) {
+    for (var r = 0; r < group.results.length; r++) {
+      total += group.results[r];
+    }
+  });
+  return total;
+}
+
+function encodeExport(rolls, format) {
+  if (format === 'csv') {
+    var lines = ['seq,received_at,dice,results,total'];
+    rolls.forEach(function(roll) {
+      var dice = roll.groups.map(function(group) { return group.results.length + group.kind; }).join('+');
+      var results = roll.groups.map(function(group) { return Array.prototype.join.call(group.results, '-'); });
+      lines.push([roll.seq, roll.receivedAt, dice, results.join('|'), rollTotal(roll)].join(','));
+    });
+    return {type: 'text/csv', body: lines.join('\n') + '\n'};
+  }
+  return {type: 'application/json', body: JSON.stringify({rolls: rolls})};
+}
+
+function scheduleExport() {
+  var settings = loadConfig().export;
+  if (!settings.url || s_export.timer || s_export.inFlight) {
+    return;
+  }
+  var delay = Math.max(0, s_export.lastAt + settings.intervalSec * 1000 - Date.now());
+  s_export.timer = setTimeout(function() {
+    s_export.timer = null;
+    flushExport();
+  }, delay);
+}
+
+function flushExport() {
+  var settings = loadConfig().export;
+  var queue = loadJson(EXPORT_QUEUE_KEY, []);
+  if (!settings.url || queue.length === 0) {
+    return;
+  }
+  var batch = queue.slice(0, EXPORT_BATCH_MAX);
+  var encoded = encodeExport(batch, settings.format);
+  var request = new XMLHttpRequest();
+  s_export.inFlight = true;
+  s_export.lastAt = Date.now();
+
+  function finish(sent) {
+    s_export.inFlight = false;
+    if (sent) {
+      // Only drop what was sent; rolls may have been queued meanwhile.
+      var latest = loadJson(EXPORT_QUEUE_KEY, []);
+      localStorage.setItem(EXPORT_QUEUE_KEY, JSON.stringify(latest.slice(batch.length)));
+      console.log('Exported ' + batch.length + ' roll(s)');
+    } else {
+      console.log('Export failed; keeping ' + queue.length + ' roll(s)');
+    }
+    scheduleExport();
+  }
+
+  request.onload = function() {
+    finish(request.status >= 200 && request.status < 300);
+  };
+  request.onerror = function() {
+    finish(false);
+  };
+  request.open('POST', settings.url);
+  request.setRequestHeader('Content-Type', encoded.type);
+  request.send(encoded.body);
+}
+
+function queueExport(rolls) {
+  if (!loadConfig().export.url || rolls.length === 0) {
+    return;
+  }
+  var queue = loadJson(EXPORT_QUEUE_KEY, []).concat(rolls);
+  if (queue.length > EXPORT_QUEUE_LIMIT) {
+    queue = queue.slice(queue.length - EXPORT_QUEUE_LIMIT);
+  }
+  localStorage.setItem(EXPORT_QUEUE_KEY, JSON.stringify(queue));
+  scheduleExport();
+}
+
+// ----- Table feed -------------------------------------------------------------
+// Players at one table point their phones at the same aggregator
+// (bench/js/table_server.js is a stand-in). Each phone posts its watch's rolls
+// in small batches and polls the table's feed with a cursor. The aggregator
+// ignores repeated (source, seq) posts and the phone drops feed entries it has
+// already relayed, so retries never show a roll twice. New entries go to the
+// watch as table_feed messages of several framed records, one in flight at a
+// time, and a backlog is cut to what the watch keeps (TABLE_FEED_CAPACITY), so
+// a busy table can't flood its inbox.
+
+var s_table = {
+  source: 0,
+  pending: [],
+  postTimer: null,
+  posting: false,
+  cursor: 0,
+  pollTimer: null,
+  polling: false,
+  seen: {},
+  seenOrder: [],
+  outbox: [],
+  sending: false
+};
+
+function fnv1a(text) {
+  var hash = 2166136261;
+  for (var i = 0; i < text.length; i++) {
+    hash ^= text.charCodeAt(i) & 0xFF;
+    hash = Math.imul(hash, 16777619) >>> 0;
+  }
+  return hash >>> 0;
+}
+
+function tableEnabled(settings) {
+  return !!(settings.url && settings.name);
+}
+
+function tableUrl(settings, path) {
+  return settings.url + '/tables/' + encodeURIComponent(settings.name) + path;
+}
+
+// Watch sequence numbers restart with the app, so the source covers both the
+// watch and this launch.
+function startTable() {
+  if (!s_table.source) {
+    var token = (typeof Pebble.getWatchToken === 'function') ? Pebble.getWatchToken() : '';
+    s_table.source = fnv1a(token + ':' + Date.now() + ':' + Math.random()) || 1;
+  }
+  scheduleTablePoll(0);
+}
+
+function queueTable(rolls) {
+  var settings = loadConfig().table;
+  if (!tableEnabled(settings) || rolls.length === 0) {
+    return;
+  }
+  rolls.forEach(function(roll) {
+    s_table.pending.push({
+      source: s_table.source,
+      player: settings.player,
+      seq: roll.seq,
+      total: rollTotal(roll),
+      groups: roll.groups.map(function(group) {
+        return [Math.max(0, DICE_KINDS.indexOf(group.kind)), group.results.length];
+      })
+    });
+  });
+  if (s_table.pending.length > TABLE_PENDING_LIMIT) {
+    s_table.pending = s_table.pending.slice(s_table.pending.length - TABLE_PENDING_LIMIT);
+  }
+  scheduleTablePost(TABLE_POST_DELAY_MS);
+}
+
+function scheduleTablePost(delay) {
+  if (s_table.postTimer || s_table.posting) {
+    return;
+  }
+  s_table.postTimer = setTimeout(function() {
+    s_table.postTimer = null;
+    postTable();
+  }, delay);
+}
+
+function postTable() {
+  var settings = loadConfig().table;
+  if (!tableEnabled(settings) || s_table.pending.length === 0) {
+    return;
+  }
+  var batch = s_table.pending.slice();
+  var request = new XMLHttpRequest();
+  s_table.posting = true;
+
+  function finish(sent) {
+    s_table.posting = false;
+    if (sent) {
+      s_table.pending = s_table.pending.slice(batch.length);
+    }
+    if (s_table.pending.length > 0) {
+      scheduleTablePost(sent ? TABLE_POST_DELAY_MS : TABLE_POLL_MS);
+    }
+  }
+
+  request.onload = function() {
+    finish(request.status >= 200 && request.status < 300);
+  };
+  request.onerror = function() {
+    finish(false);
+  };
+  request.open('POST', tableUrl(settings, '/rolls'));
+  request.setRequestHeader('Content-Type', 'application/json');
+  request.send(JSON.stringify({rolls: batch}));
+}
+
+function scheduleTablePoll(delay) {
+  if (s_table.pollTimer || s_table.polling || !tableEnabled(loadConfig().table)) {
+    return;
+  }
+  s_table.pollTimer = setTimeout(function() {
+    s_table.pollTimer = null;
+    pollTable();
+  }, delay);
+}
+
+function pollTable() {
+  var settings = loadConfig().table;
+  if (!tableEnabled(settings)) {
+    return;
+  }
+  var request = new XMLHttpRequest();
+  s_table.polling = true;
+
+  request.onload = function() {
+    s_table.polling = false;
+    if (request.status === 200) {
+      try {
+        var feed = JSON.parse(request.responseText);
+        s_table.cursor = feed.cursor;
+        relayTable(feed.entries || []);
+      } catch (e) {
+        console.log('Ignoring malformed table feed');
+      }
+    }
+    scheduleTablePoll(TABLE_POLL_MS);
+  };
+  request.onerror = function() {
+    s_table.polling = false;
+    scheduleTablePoll(TABLE_POLL_MS);
+  };
+  request.open('GET', tableUrl(settings, '/feed?since=' + s_table.cursor));
+  request.send();
+}
+
+function relayTable(entries) {
+  entries.forEach(function(entry) {
+    var key = entry.source + ':' + entry.seq;
+    if (s_table.seen[key]) {
+      return;
+    }
+    s_table.seen[key] = true;
+    s_table.seenOrder.push(key);
+    if (s_table.seenOrder.length > TABLE_SEEN_LIMIT) {
+      delete s_table.seen[s_table.seenOrder.shift()];
+    }
+    s_table.outbox.push(entry);
+  });
+  if (s_table.outbox.length > TABLE_FEED_CAPACITY) {
+    s_table.outbox = s_table.outbox.slice(s_table.outbox.length - TABLE_FEED_CAPACITY);
+  }
+  flushTableFeed();
+}
+
+// Record layout in src/table_feed.c.
+function encodeTableEntry(entry) {
+  var bytes = [];
+  var source = entry.source >>> 0;
+  bytes.push(source & 0xFF, (source >>> 8) & 0xFF, (source >>> 16) & 0xFF, (source >>> 24) & 0xFF);
+  pushU16(bytes, entry.seq);
+  pushU16(bytes, Math.min(entry.total, 0xFFFF));
+  var name = String(entry.player || '').substring(0, TABLE_NAME_LENGTH);
+  bytes.push(name.length);
+  for (var i = 0; i < name.length; i++) {
+    var code = name.charCodeAt(i);
+    bytes.push(code < 0x80 ? code : 0x3F);
+  }
+  var groups = (entry.groups || []).slice(0, MAX_DICE_GROUPS);
+  bytes.push(groups.length);
+  groups.forEach(function(group) {
+    bytes.push(group[0], group[1]);
+  });
+  return bytes;
+}
+
+function flushTableFeed() {
+  if (s_table.sending || s_table.outbox.length === 0) {
+    return;
+  }
+  var body = [];
+  var count = 0;
+  while (count < s_table.outbox.length) {
+    var framed = frame.encode(encodeTableEntry(s_table.outbox[count]));
+    if (body.length + framed.length > TABLE_BODY_MAX) {
+      break;
+    }
+    body = body.concat(framed);
+    count++;
+  }
+  var batch = s_table.outbox.splice(0, count);
+  s_table.sending = true;
+  sendMessage('tableFeed', {entries: body}, function() {
+    s_table.sending = false;
+    flushTableFeed();
+  }, function() {
+    s_table.sending = false;
+    s_table.outbox = batch.concat(s_table.outbox).slice(-TABLE_FEED_CAPACITY);
+    setTimeout(flushTableFeed, TABLE_RETRY_MS);
+  });
+}
+
+Pebble.addEventListener('showConfiguration', function() {
+  Pebble.openURL(buildConfigPage(loadConfig()));
+});
+
+Pebble.addEventListener('webviewclosed', function(e) {
+  if (!e || !e.response) {
+    return;
+  }
+  var config;
+  try {
+    config = JSON.parse(decodeURIComponent(e.response));
+  } catch (err) {
+    console.log('Ignoring malformed settings');
+    return;
+  }
+  localStorage.setItem(CONFIG_STORAGE_KEY, JSON.stringify(config));
+  syncConfig();
+  scheduleExport();
+  startTable();
+});
+
+Pebble.addEventListener('ready', function(e) {
+  migrateRollLog();
+  sendMessage('appReady', {}, syncConfig);
+  scheduleExport();
+  startTable();
+});
+
+Pebble.addEventListener('appmessage', function(e) {
+  var message = protocol.decode(e.payload[protocol.MESSAGE_KEY] || []);
+  if (!message) {
+    return;
+  }
+  if (message.type === 'rollLog') {
+    var rolls = decodeRollLog(message.records);
+    console.log('Received ' + rolls.length + ' roll(s)');
+    // Export and the table feed don't depend on local storage having room.
+    storeRolls(rolls);
+    queueExport(rolls);
+    queueTable(rolls);
+  } else if (message.type === 'oddsRequest') {
+    answerOddsRequest(message);
+  } else if (message.type === 'historyRequest') {
+    answerHistoryRequest(message);
+  }
+});
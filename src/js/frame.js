@@ -0,0 +1,59 @@
+// Record framing, the phone-side twin of src/frame.c. Each record travels as
+// [length:1-2][record...][crc8], the length in little-endian base 128 and the
+// CRC-8 (polynomial 0x07) over the length bytes and the record.
+
+var RECORD_MAX = 0x3FFF;
+
+function crc8(bytes, start, end) {
+  var crc = 0;
+  for (var i = start; i < end; i++) {
+    crc ^= bytes[i];
+    for (var bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x80) ? ((crc << 1) ^ 0x07) & 0xFF : (crc << 1) & 0xFF;
+    }
+  }
+  return crc;
+}
+
+// Appends one framed record to `out` (an array) and returns it.
+function encode(record, out) {
+  out = out || [];
+  if (record.length > RECORD_MAX) {
+    throw new RangeError('record too long: ' + record.length);
+  }
+  var start = out.length;
+  if (record.length < 0x80) {
+    out.push(record.length);
+  } else {
+    out.push(0x80 | (record.length & 0x7F), record.length >> 7);
+  }
+  for (var i = 0; i < record.length; i++) {
+    out.push(record[i] & 0xFF);
+  }
+  out.push(crc8(out, start, out.length));
+  return out;
+}
+
+// Splits a body into its records. Stops at the first truncated or corrupt
+// frame, since its length can't be trusted to find the next one.
+function decode(bytes) {
+  var records = [];
+  var offset = 0;
+  while (offset + 2 <= bytes.length) {
+    var prefix = 1;
+    var length = bytes[offset];
+    if (length & 0x80) {
+      prefix = 2;
+      length = (length & 0x7F) | (bytes[offset + 1] << 7);
+    }
+    var end = offset + prefix + length;
+    if (end + 1 > bytes.length || crc8(bytes, offset, end) !== bytes[end]) {
+      return {records: records, dropped: bytes.length - offset};
+    }
+    records.push(Array.prototype.slice.call(bytes, offset + prefix, end));
+    offset = end + 1;
+  }
+  return {records: records, dropped: bytes.length - offset};
+}
+
+module.exports = {RECORD_MAX: RECORD_MAX, crc8: crc8, encode: encode, decode: decode};
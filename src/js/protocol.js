@@ -0,0 +1,186 @@
+// GENERATED by tools/protocol_gen.py from protocol/dice_protocol.json -- do not edit.
+//
+// encode(name, fields) -> [id, ...body] for the PAYLOAD key; decode(bytes) ->
+// {type: name, ...fields} or null. Field names are camelCase; "bytes" fields
+// are plain arrays.
+
+var MESSAGE_KEY = 'PAYLOAD';
+
+var IDS = {
+  appReady: 1,
+  rollLog: 2,
+  oddsRequest: 3,
+  oddsReply: 4,
+  historyRequest: 5,
+  historyPage: 6,
+  preset: 7,
+  profile: 8,
+  tableFeed: 9
+};
+
+function putU16(out, v) {
+  out.push(v & 0xFF, (v >> 8) & 0xFF);
+}
+
+function putU32(out, v) {
+  out.push(v & 0xFF, (v >>> 8) & 0xFF, (v >>> 16) & 0xFF, (v >>> 24) & 0xFF);
+}
+
+function getU16(b, o) {
+  return b[o] | (b[o + 1] << 8);
+}
+
+function getU32(b, o) {
+  return (b[o] | (b[o + 1] << 8) | (b[o + 2] << 16) | (b[o + 3] << 24)) >>> 0;
+}
+
+var ENCODERS = {
+  appReady: function(m, out) {
+  },
+  rollLog: function(m, out) {
+    for (var i = 0; i < (m.records || []).length; i++) {
+      out.push(m.records[i] & 0xFF);
+    }
+  },
+  oddsRequest: function(m, out) {
+    putU32(out, (m.hash || 0));
+    out.push((m.groupCount || 0) & 0xFF);
+    for (var i = 0; i < (m.groups || []).length; i++) {
+      out.push(m.groups[i] & 0xFF);
+    }
+  },
+  oddsReply: function(m, out) {
+    putU32(out, (m.hash || 0));
+    putU16(out, (m.minTotal || 0));
+    putU16(out, (m.maxTotal || 0));
+    for (var j = 0; j < 32; j++) {
+      putU16(out, ((m.cdf || [])[j] || 0));
+    }
+  },
+  historyRequest: function(m, out) {
+    putU16(out, (m.first || 0));
+    out.push((m.count || 0) & 0xFF);
+  },
+  historyPage: function(m, out) {
+    putU16(out, (m.first || 0));
+    putU16(out, (m.total || 0));
+    out.push((m.entryCount || 0) & 0xFF);
+    for (var i = 0; i < (m.entries || []).length; i++) {
+      out.push(m.entries[i] & 0xFF);
+    }
+  },
+  preset: function(m, out) {
+    for (var i = 0; i < (m.records || []).length; i++) {
+      out.push(m.records[i] & 0xFF);
+    }
+  },
+  profile: function(m, out) {
+    for (var i = 0; i < (m.records || []).length; i++) {
+      out.push(m.records[i] & 0xFF);
+    }
+  },
+  tableFeed: function(m, out) {
+    for (var i = 0; i < (m.entries || []).length; i++) {
+      out.push(m.entries[i] & 0xFF);
+    }
+  }
+};
+
+var DECODERS = {
+  1: function(b) {
+    if (b.length < 1) {
+      return null;
+    }
+    var m = {type: 'appReady'};
+    return m;
+  },
+  2: function(b) {
+    if (b.length < 1) {
+      return null;
+    }
+    var m = {type: 'rollLog'};
+    m.records = Array.prototype.slice.call(b, 1);
+    return m;
+  },
+  3: function(b) {
+    if (b.length < 6) {
+      return null;
+    }
+    var m = {type: 'oddsRequest'};
+    m.hash = getU32(b, 1);
+    m.groupCount = b[5];
+    m.groups = Array.prototype.slice.call(b, 6);
+    return m;
+  },
+  4: function(b) {
+    if (b.length < 73) {
+      return null;
+    }
+    var m = {type: 'oddsReply'};
+    m.hash = getU32(b, 1);
+    m.minTotal = getU16(b, 5);
+    m.maxTotal = getU16(b, 7);
+    m.cdf = [];
+    for (var j = 0; j < 32; j++) {
+      m.cdf.push(getU16(b, 9 + j * 2));
+    }
+    return m;
+  },
+  5: function(b) {
+    if (b.length < 4) {
+      return null;
+    }
+    var m = {type: 'historyRequest'};
+    m.first = getU16(b, 1);
+    m.count = b[3];
+    return m;
+  },
+  6: function(b) {
+    if (b.length < 6) {
+      return null;
+    }
+    var m = {type: 'historyPage'};
+    m.first = getU16(b, 1);
+    m.total = getU16(b, 3);
+    m.entryCount = b[5];
+    m.entries = Array.prototype.slice.call(b, 6);
+    return m;
+  },
+  7: function(b) {
+    if (b.length < 1) {
+      return null;
+    }
+    var m = {type: 'preset'};
+    m.records = Array.prototype.slice.call(b, 1);
+    return m;
+  },
+  8: function(b) {
+    if (b.length < 1) {
+      return null;
+    }
+    var m = {type: 'profile'};
+    m.records = Array.prototype.slice.call(b, 1);
+    return m;
+  },
+  9: function(b) {
+    if (b.length < 1) {
+      return null;
+    }
+    var m = {type: 'tableFeed'};
+    m.entries = Array.prototype.slice.call(b, 1);
+    return m;
+  }
+};
+
+function encode(name, fields) {
+  var out = [IDS[name]];
+  ENCODERS[name](fields || {}, out);
+  return out;
+}
+
+function decode(bytes) {
+  var decoder = bytes && bytes.length > 0 ? DECODERS[bytes[0]] : null;
+  return decoder ? decoder(bytes) : null;
+}
+
+module.exports = {MESSAGE_KEY: MESSAGE_KEY, IDS: IDS, encode: encode, decode: decode};
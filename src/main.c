@@ -1,5 +1,8 @@
 #include <pebble.h>
 
+#include "comm.h"
+#include "roll_log.h"
+#include "sched.h"
 #include "state.h"
 #include "ui.h"
 
@@ -22,6 +25,10 @@ static void prv_up_click_handler(ClickRecognizerRef recognizer, void *context) {
   state_handle_up();
 }
 
+static void prv_up_long_click_handler(ClickRecognizerRef recognizer, void *context) {
+  state_handle_up_long();
+}
+
 static void prv_down_click_handler(ClickRecognizerRef recognizer, void *context) {
   state_handle_down();
 }
@@ -35,14 +42,11 @@ static void prv_click_config_provider(void *context) {
   window_long_click_subscribe(BUTTON_ID_SELECT, 600, prv_select_long_click_handler, NULL);
   window_single_click_subscribe(BUTTON_ID_BACK, prv_back_click_handler);
   window_single_click_subscribe(BUTTON_ID_UP, prv_up_click_handler);
+  window_long_click_subscribe(BUTTON_ID_UP, 600, prv_up_long_click_handler, NULL);
   window_single_click_subscribe(BUTTON_ID_DOWN, prv_down_click_handler);
   window_long_click_subscribe(BUTTON_ID_DOWN, 600, prv_down_long_click_handler, NULL);
 }
 
-static void prv_accel_tap_handler(AccelAxisType axis, int32_t direction) {
-  state_handle_tap();
-}
-
 static void prv_window_load(Window *window) {
   window_set_click_config_provider(window, prv_click_config_provider);
   ui_init(window);
@@ -59,21 +63,24 @@ static void prv_window_unload(Window *window) {
 }
 
 static void prv_init(void) {
+  sched_init();
+  comm_init();
+  roll_log_init();
   s_main_window = window_create();
   window_set_window_handlers(s_main_window, (WindowHandlers) {
     .load = prv_window_load,
     .unload = prv_window_unload,
   });
   window_stack_push(s_main_window, true);
-  accel_tap_service_subscribe(prv_accel_tap_handler);
 }
 
 static void prv_deinit(void) {
-  accel_tap_service_unsubscribe();
   if (s_main_window) {
     window_destroy(s_main_window);
     s_main_window = NULL;
   }
+  comm_deinit();
+  sched_deinit();
 }
 
 int main(void) {
@@ -0,0 +1,257 @@
+#include "msg_queue.h"
+
+#include <string.h>
+
+#include "sched.h"
+
+// -----------------------------------------------------------------------------
+// MESSAGE QUEUE MODULE
+// -----------------------------------------------------------------------------
+// Outbound AppMessage queue. Producers push message bodies and return
+// immediately; the queue keeps them serialized in one byte buffer as
+//
+//   [size:2][flags:1][message id:1][body...]
+//
+// and sends the front entry when the phone is ready and nothing is in flight.
+// The id sits right before the body, so [id][body] goes out as the PAYLOAD
+// byte array without another copy.
+// Busy/NACK results are retried with exponential backoff through the
+// scheduler. When a push doesn't fit, adjacent mergeable entries are folded
+// together first (saving their headers), then the oldest entries are dropped.
+// Counters in MsgQueueStats make throughput tuning measurable.
+//
+// Safe tweaks:
+// - MSG_QUEUE_BUFFER_SIZE bounds how much can wait while the phone is away.
+// - MSG_QUEUE_BACKOFF_* shape the retry schedule.
+
+#define MSG_QUEUE_BUFFER_SIZE 3072
+#define MSG_QUEUE_HEADER_SIZE 4
+// The message id byte travels with the body.
+#define MSG_QUEUE_ID_SIZE 1
+#define MSG_QUEUE_BACKOFF_MIN_MS 250
+#define MSG_QUEUE_BACKOFF_MAX_MS 8000
+
+typedef struct {
+  uint16_t size;
+  uint8_t flags;
+  uint8_t id;
+} MsgQueueEntry;
+
+typedef struct {
+  uint8_t buffer[MSG_QUEUE_BUFFER_SIZE];
+  uint16_t used;
+  uint16_t payload_max;
+  bool ready;
+  bool in_flight;
+  uint32_t backoff_ms;
+  SchedTimer *retry_timer;
+  MsgQueueStats stats;
+} MsgQueue;
+
+static MsgQueue s_queue;
+
+static void prv_send_next(void);
+
+static MsgQueueEntry prv_read_entry(uint16_t offset) {
+  MsgQueueEntry entry;
+  const uint8_t *p = &s_queue.buffer[offset];
+  entry.size = (uint16_t)(p[0] | (p[1] << 8));
+  entry.flags = p[2];
+  entry.id = p[3];
+  return entry;
+}
+
+static void prv_write_entry(uint16_t offset, const MsgQueueEntry *entry) {
+  uint8_t *p = &s_queue.buffer[offset];
+  p[0] = entry->size & 0xFF;
+  p[1] = entry->size >> 8;
+  p[2] = entry->flags;
+  p[3] = entry->id;
+}
+
+static uint16_t prv_entry_span(uint16_t offset) {
+  return MSG_QUEUE_HEADER_SIZE + prv_read_entry(offset).size;
+}
+
+static void prv_remove_at(uint16_t offset, uint16_t length) {
+  memmove(&s_queue.buffer[offset], &s_queue.buffer[offset + length], s_queue.used - offset - length);
+  s_queue.used -= length;
+}
+
+// Folds the entry after `offset` into it when both are mergeable, share an id
+// and still fit one message together.
+static bool prv_merge_next(uint16_t offset) {
+  const uint16_t next = offset + prv_entry_span(offset);
+  if (next >= s_queue.used) {
+    return false;
+  }
+  MsgQueueEntry entry = prv_read_entry(offset);
+  const MsgQueueEntry following = prv_read_entry(next);
+  if (!(entry.flags & MSG_QUEUE_MERGEABLE) || !(following.flags & MSG_QUEUE_MERGEABLE) ||
+      entry.id != following.id || entry.size + following.size > s_queue.payload_max) {
+    return false;
+  }
+  prv_remove_at(next, MSG_QUEUE_HEADER_SIZE);
+  entry.size += following.size;
+  prv_write_entry(offset, &entry);
+  s_queue.stats.merged++;
+  return true;
+}
+
+// The entry in flight must stay byte-for-byte as sent until it's acknowledged.
+static uint16_t prv_first_movable(void) {
+  return (s_queue.in_flight && s_queue.used > 0) ? prv_entry_span(0) : 0;
+}
+
+static void prv_compact(void) {
+  uint16_t offset = prv_first_movable();
+  while (offset < s_queue.used) {
+    if (!prv_merge_next(offset)) {
+      offset += prv_entry_span(offset);
+    }
+  }
+}
+
+static void prv_make_room(uint16_t needed) {
+  if (s_queue.used + needed <= MSG_QUEUE_BUFFER_SIZE) {
+    return;
+  }
+  prv_compact();
+  const uint16_t first = prv_first_movable();
+  while (s_queue.used + needed > MSG_QUEUE_BUFFER_SIZE && first < s_queue.used) {
+    prv_remove_at(first, prv_entry_span(first));
+    s_queue.stats.dropped++;
+  }
+}
+
+static void prv_retry_cb(void *context) {
+  s_queue.retry_timer = NULL;
+  prv_send_next();
+}
+
+static void prv_schedule_retry(void) {
+  s_queue.stats.retried++;
+  if (s_queue.backoff_ms == 0) {
+    s_queue.backoff_ms = MSG_QUEUE_BACKOFF_MIN_MS;
+  } else if (s_queue.backoff_ms < MSG_QUEUE_BACKOFF_MAX_MS) {
+    s_queue.backoff_ms *= 2;
+  }
+  if (!s_queue.retry_timer) {
+    s_queue.retry_timer = sched_timer_register(s_queue.backoff_ms, prv_retry_cb, NULL);
+  }
+}
+
+static void prv_send_next(void) {
+  if (!s_queue.ready || s_queue.in_flight || s_queue.retry_timer || s_queue.used == 0) {
+    return;
+  }
+
+  while (prv_merge_next(0)) {
+  }
+  const MsgQueueEntry entry = prv_read_entry(0);
+
+  DictionaryIterator *iter = NULL;
+  const AppMessageResult begin = app_message_outbox_begin(&iter);
+  if (begin != APP_MSG_OK || !iter) {
+    prv_schedule_retry();
+    return;
+  }
+  dict_write_data(iter, MESSAGE_KEY_PAYLOAD, &s_queue.buffer[MSG_QUEUE_HEADER_SIZE - MSG_QUEUE_ID_SIZE],
+                  entry.size + MSG_QUEUE_ID_SIZE);
+  if (app_message_outbox_send() != APP_MSG_OK) {
+    prv_schedule_retry();
+    return;
+  }
+  s_queue.in_flight = true;
+}
+
+void msg_queue_init(uint32_t outbox_size) {
+  memset(&s_queue, 0, sizeof(s_queue));
+  // One tuple per message; leave room for the dictionary headers and the id.
+  const uint32_t overhead = dict_calc_buffer_size(1, 0) + MSG_QUEUE_ID_SIZE;
+  uint32_t payload_max = (outbox_size > overhead) ? outbox_size - overhead : 0;
+  if (payload_max > MSG_QUEUE_BUFFER_SIZE - MSG_QUEUE_HEADER_SIZE) {
+    payload_max = MSG_QUEUE_BUFFER_SIZE - MSG_QUEUE_HEADER_SIZE;
+  }
+  s_queue.payload_max = (uint16_t)payload_max;
+}
+
+void msg_queue_deinit(void) {
+  if (s_queue.retry_timer) {
+    sched_timer_cancel(s_queue.retry_timer);
+    s_queue.retry_timer = NULL;
+  }
+#if defined(DICE_DEBUG)
+  const MsgQueueStats *stats = &s_queue.stats;
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "msg_queue: queued %lu sent %lu retried %lu dropped %lu merged %lu bytes %lu",
+          (unsigned long)stats->queued, (unsigned long)stats->sent, (unsigned long)stats->retried,
+          (unsigned long)stats->dropped, (unsigned long)stats->merged, (unsigned long)stats->bytes_sent);
+#endif
+}
+
+bool msg_queue_push(uint8_t message_id, const uint8_t *body, uint16_t size, uint8_t flags) {
+  if ((!body && size > 0) || size > s_queue.payload_max) {
+    s_queue.stats.dropped++;
+    return false;
+  }
+
+  const uint16_t needed = MSG_QUEUE_HEADER_SIZE + size;
+  prv_make_room(needed);
+  if (s_queue.used + needed > MSG_QUEUE_BUFFER_SIZE) {
+    s_queue.stats.dropped++;
+    return false;
+  }
+
+  const MsgQueueEntry entry = {.size = size, .flags = flags, .id = message_id};
+  prv_write_entry(s_queue.used, &entry);
+  if (size > 0) {
+    memcpy(&s_queue.buffer[s_queue.used + MSG_QUEUE_HEADER_SIZE], body, size);
+  }
+  s_queue.used += needed;
+  s_queue.stats.queued++;
+  prv_send_next();
+  return true;
+}
+
+uint16_t msg_queue_payload_max(void) {
+  return s_queue.payload_max;
+}
+
+void msg_queue_set_ready(bool ready) {
+  s_queue.ready = ready;
+  prv_send_next();
+}
+
+void msg_queue_handle_sent(void) {
+  if (!s_queue.in_flight) {
+    return;
+  }
+  const MsgQueueEntry entry = prv_read_entry(0);
+  s_queue.stats.sent++;
+  s_queue.stats.bytes_sent += entry.size;
+  prv_remove_at(0, MSG_QUEUE_HEADER_SIZE + entry.size);
+  s_queue.in_flight = false;
+  s_queue.backoff_ms = 0;
+  prv_send_next();
+}
+
+void msg_queue_handle_failed(AppMessageResult reason) {
+  s_queue.in_flight = false;
+  // Malformed messages will never go through; don't let them block the rest.
+  if (reason == APP_MSG_INVALID_ARGS || reason == APP_MSG_BUFFER_OVERFLOW) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Dropping unsendable message: %d", (int)reason);
+    if (s_queue.used > 0) {
+      prv_remove_at(0, prv_entry_span(0));
+    }
+    s_queue.stats.dropped++;
+    prv_send_next();
+    return;
+  }
+  prv_schedule_retry();
+  APP_LOG(APP_LOG_LEVEL_WARNING, "Send failed (%d), retrying in %lu ms", (int)reason,
+          (unsigned long)s_queue.backoff_ms);
+}
+
+const MsgQueueStats *msg_queue_stats(void) {
+  return &s_queue.stats;
+}
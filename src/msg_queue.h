@@ -0,0 +1,32 @@
+#pragma once
+
+#include <pebble.h>
+
+// Entries pushed with this flag may be concatenated with neighbouring entries
+// of the same message id into one message, both when sending and to free
+// memory. Only valid for bodies that are a plain run of records.
+#define MSG_QUEUE_MERGEABLE (1 << 0)
+
+typedef struct {
+  uint32_t queued;
+  uint32_t sent;
+  uint32_t retried;
+  uint32_t dropped;
+  uint32_t merged;
+  uint32_t bytes_sent;
+} MsgQueueStats;
+
+void msg_queue_init(uint32_t outbox_size);
+void msg_queue_deinit(void);
+
+// Copies the payload into the queue and returns immediately. Under memory
+// pressure the oldest entries are merged, then dropped, to make room.
+bool msg_queue_push(uint8_t message_id, const uint8_t *body, uint16_t size, uint8_t flags);
+// Largest body a single entry (and a single message) may carry.
+uint16_t msg_queue_payload_max(void);
+
+void msg_queue_set_ready(bool ready);
+void msg_queue_handle_sent(void);
+void msg_queue_handle_failed(AppMessageResult reason);
+
+const MsgQueueStats *msg_queue_stats(void);
@@ -0,0 +1,237 @@
+#include "odds.h"
+
+#include <string.h>
+
+#include "comm.h"
+#include "dicecore/distribution.h"
+#include "msg_queue.h"
+#include "sched.h"
+
+// -----------------------------------------------------------------------------
+// ODDS MODULE
+// -----------------------------------------------------------------------------
+// Answers "how good was that roll?" with the exact distribution of the grand
+// total. Small pools are convolved right here (dicecore/distribution.c);
+// anything whose total can span more than ODDS_LOCAL_MAX_SUMS values (think 8
+// groups of 64d100) is sent to PebbleKit JS, which does the heavy lifting and
+// replies with a downsampled CDF. Every result is cached under a hash of the
+// configuration, so repeat rolls of the same preset never recompute or hit
+// the radio again. A request that gets no reply within ODDS_REQUEST_TIMEOUT_MS
+// is forgotten, so the next render asks again.
+//
+// Request and reply layouts (odds_request/odds_reply) live in
+// protocol/dice_protocol.json; the request's groups are [kind][count] pairs.
+//
+// Safe tweaks:
+// - ODDS_LOCAL_MAX_SUMS moves the watch/phone split (RAM and CPU vs latency).
+// - ODDS_CACHE_SLOTS trades RAM for more remembered presets.
+
+#define ODDS_LOCAL_MAX_SUMS 512
+#define ODDS_CACHE_SLOTS 4
+#define ODDS_REQUEST_TIMEOUT_MS 5000
+#define ODDS_REQUEST_MAX (PROTO_ODDS_REQUEST_FIXED_SIZE + MAX_DICE_GROUPS * 2)
+
+typedef struct {
+  OddsCdf cache[ODDS_CACHE_SLOTS];
+  bool cache_valid[ODDS_CACHE_SLOTS];
+  int cache_next;
+  uint32_t pending_hash;
+  bool pending;
+  SchedTimer *timeout_timer;
+  OddsReadyHandler on_ready;
+  void *ready_context;
+} OddsState;
+
+static OddsState s_odds;
+
+// FNV-1a over the (kind, count) pairs; results don't matter, only the setup.
+static uint32_t prv_config_hash(const DiceModel *model) {
+  uint32_t hash = 2166136261u;
+  for (int g = 0; g < model_group_count(model); ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    const uint8_t bytes[2] = {(uint8_t)group->die_def_index, (uint8_t)group->count};
+    for (int i = 0; i < 2; ++i) {
+      hash ^= bytes[i];
+      hash *= 16777619u;
+    }
+  }
+  return hash;
+}
+
+static const OddsCdf *prv_cache_find(uint32_t hash) {
+  for (int i = 0; i < ODDS_CACHE_SLOTS; ++i) {
+    if (s_odds.cache_valid[i] && s_odds.cache[i].hash == hash) {
+      return &s_odds.cache[i];
+    }
+  }
+  return NULL;
+}
+
+static OddsCdf *prv_cache_slot(void) {
+  const int index = s_odds.cache_next;
+  s_odds.cache_next = (s_odds.cache_next + 1) % ODDS_CACHE_SLOTS;
+  s_odds.cache_valid[index] = true;
+  return &s_odds.cache[index];
+}
+
+// Sum index sampled by CDF point `i`; shared with the phone's downsampling.
+static int prv_point_offset(int i, int span) {
+  return (i * span) / (ODDS_CDF_POINTS - 1);
+}
+
+// Exact distribution downsampled to the cached CDF.
+static bool prv_compute_local(const DiceModel *model, OddsCdf *out) {
+  int min_total, max_total;
+  distribution_range(model, &min_total, &max_total);
+  const int span = max_total - min_total;
+
+  uint32_t *dist = malloc((span + 1) * sizeof(uint32_t));
+  if (!dist) {
+    return false;
+  }
+  distribution_compute(model, dist);
+
+  uint64_t mass = 0;
+  for (int r = 0; r <= span; ++r) {
+    mass += dist[r];
+  }
+  out->min_total = (uint16_t)min_total;
+  out->max_total = (uint16_t)max_total;
+  uint64_t cumulative = 0;
+  int r = 0;
+  for (int i = 0; i < ODDS_CDF_POINTS; ++i) {
+    const int until = prv_point_offset(i, span);
+    for (; r <= until; ++r) {
+      cumulative += dist[r];
+    }
+    out->cdf[i] = mass ? (uint16_t)((cumulative * 65535) / mass) : 0;
+  }
+  free(dist);
+  return true;
+}
+
+static void prv_cancel_timeout(void) {
+  if (s_odds.timeout_timer) {
+    sched_timer_cancel(s_odds.timeout_timer);
+    s_odds.timeout_timer = NULL;
+  }
+}
+
+static void prv_timeout_cb(void *data) {
+  s_odds.timeout_timer = NULL;
+  s_odds.pending = false;
+}
+
+static void prv_request_remote(const DiceModel *model, uint32_t hash) {
+  if (s_odds.pending && s_odds.pending_hash == hash) {
+    return;
+  }
+  uint8_t groups[MAX_DICE_GROUPS * 2];
+  uint16_t groups_length = 0;
+  for (int g = 0; g < model_group_count(model); ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    groups[groups_length++] = (uint8_t)group->die_def_index;
+    groups[groups_length++] = (uint8_t)group->count;
+  }
+  const ProtoOddsRequest msg = {
+    .hash = hash,
+    .group_count = (uint8_t)model_group_count(model),
+    .groups = groups,
+    .groups_length = groups_length,
+  };
+  uint8_t request[ODDS_REQUEST_MAX];
+  const uint16_t size = proto_odds_request_pack(&msg, request, sizeof(request));
+  if (size > 0 && msg_queue_push(PROTO_MSG_ODDS_REQUEST, request, size, 0)) {
+    s_odds.pending = true;
+    s_odds.pending_hash = hash;
+    prv_cancel_timeout();
+    s_odds.timeout_timer = sched_timer_register(ODDS_REQUEST_TIMEOUT_MS, prv_timeout_cb, NULL);
+  }
+}
+
+static void prv_reply_received(const uint8_t *body, uint16_t length, void *context) {
+  ProtoOddsReply reply;
+  if (!proto_odds_reply_unpack(body, length, &reply)) {
+    return;
+  }
+  const uint32_t hash = reply.hash;
+  if (s_odds.pending && s_odds.pending_hash == hash) {
+    prv_cancel_timeout();
+    s_odds.pending = false;
+  }
+  if (prv_cache_find(hash)) {
+    return;
+  }
+
+  OddsCdf *cdf = prv_cache_slot();
+  cdf->hash = hash;
+  cdf->min_total = reply.min_total;
+  cdf->max_total = reply.max_total;
+  memcpy(cdf->cdf, reply.cdf, sizeof(cdf->cdf));
+  if (s_odds.on_ready) {
+    s_odds.on_ready(s_odds.ready_context);
+  }
+}
+
+// Linear interpolation between the two CDF points around `total`.
+static int prv_percentile(const OddsCdf *cdf, int total) {
+  if (total <= cdf->min_total) {
+    return (cdf->cdf[0] * 100 + 32767) / 65535;
+  }
+  if (total >= cdf->max_total) {
+    return 100;
+  }
+  const int span = cdf->max_total - cdf->min_total;
+  const int r = total - cdf->min_total;
+  int i = 0;
+  while (i < ODDS_CDF_POINTS - 2 && prv_point_offset(i + 1, span) <= r) {
+    ++i;
+  }
+  const int r0 = prv_point_offset(i, span);
+  const int r1 = prv_point_offset(i + 1, span);
+  int value = cdf->cdf[i];
+  if (r1 > r0) {
+    value += ((cdf->cdf[i + 1] - cdf->cdf[i]) * (r - r0)) / (r1 - r0);
+  }
+  return (value * 100 + 32767) / 65535;
+}
+
+void odds_init(OddsReadyHandler on_ready, void *context) {
+  memset(&s_odds, 0, sizeof(s_odds));
+  s_odds.on_ready = on_ready;
+  s_odds.ready_context = context;
+  comm_subscribe(PROTO_MSG_ODDS_REPLY, prv_reply_received, NULL);
+}
+
+void odds_deinit(void) {
+  prv_cancel_timeout();
+  s_odds.on_ready = NULL;
+  s_odds.pending = false;
+}
+
+int odds_total_percentile(const DiceModel *model, int total) {
+  if (!model || model_group_count(model) == 0) {
+    return ODDS_PENDING;
+  }
+
+  const uint32_t hash = prv_config_hash(model);
+  const OddsCdf *cached = prv_cache_find(hash);
+  if (cached) {
+    return prv_percentile(cached, total);
+  }
+
+  int min_total, max_total;
+  distribution_range(model, &min_total, &max_total);
+  if (max_total - min_total < ODDS_LOCAL_MAX_SUMS) {
+    OddsCdf local;
+    if (prv_compute_local(model, &local)) {
+      local.hash = hash;
+      OddsCdf *slot = prv_cache_slot();
+      *slot = local;
+      return prv_percentile(slot, total);
+    }
+  }
+
+  prv_request_remote(model, hash);
+  return ODDS_PENDING;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "dicecore/model.h"
+
+#define ODDS_CDF_POINTS 32
+#define ODDS_PENDING (-1)
+
+typedef void (*OddsReadyHandler)(void *context);
+
+// Distribution of the grand total of a dice configuration, downsampled to
+// ODDS_CDF_POINTS evenly spaced sums between min_total and max_total.
+// cdf[i] is P(total <= that sum) scaled to 0..65535. The phone narrows the
+// window to where the CDF actually moves, so the points aren't spent on tails.
+typedef struct {
+  uint32_t hash;
+  uint16_t min_total;
+  uint16_t max_total;
+  uint16_t cdf[ODDS_CDF_POINTS];
+} OddsCdf;
+
+// `on_ready` runs when a distribution requested from the phone arrives.
+void odds_init(OddsReadyHandler on_ready, void *context);
+void odds_deinit(void);
+
+// Percentage of outcomes (0..100) at or below `total` for the model's groups.
+// Returns ODDS_PENDING while the phone is still working on it.
+int odds_total_percentile(const DiceModel *model, int total);
@@ -0,0 +1,14 @@
+#pragma once
+
+// Every persistent storage key the app uses lives here so modules can never
+// collide on a key. Append new keys; never renumber existing ones, or stored
+// settings from older versions will be read back as the wrong thing.
+typedef enum {
+  PERSIST_KEY_ROLL_PROFILE = 1,
+  // Timing overrides, one key per RollProfileId (room for 8 profiles).
+  PERSIST_KEY_PROFILE_TIMING_FIRST = 2,
+  // Dice presets, one key per slot (PRESET_MAX of them).
+  PERSIST_KEY_PRESET_FIRST = 10,
+  PERSIST_KEY_PRESET_LAST = 17,
+  PERSIST_KEY_SHAKE_TO_ROLL = 18,
+} PersistKey;
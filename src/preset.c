@@ -0,0 +1,95 @@
+#include "preset.h"
+
+#include <string.h>
+
+#include "persist_keys.h"
+
+// -----------------------------------------------------------------------------
+// PRESET MODULE
+// -----------------------------------------------------------------------------
+// Fixed slots of named dice configurations. Each slot is its own persist key,
+// so a settings change only rewrites the presets that actually changed (see
+// config_sync.c for how they arrive from the phone).
+//
+// Safe tweaks:
+// - PRESET_MAX (preset.h) must stay within the keys reserved in
+//   persist_keys.h.
+
+typedef struct {
+  Preset presets[PRESET_MAX];
+  bool filled[PRESET_MAX];
+} PresetStore;
+
+static PresetStore s_store;
+
+static bool prv_valid(const Preset *preset) {
+  if (preset->group_count == 0 || preset->group_count > MAX_DICE_GROUPS) {
+    return false;
+  }
+  for (int g = 0; g < preset->group_count; ++g) {
+    if (preset->kinds[g] >= DICE_KIND_COUNT || preset->counts[g] < 1 || preset->counts[g] > MAX_DICE_PER_GROUP) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void preset_init(void) {
+  memset(&s_store, 0, sizeof(s_store));
+  for (int slot = 0; slot < PRESET_MAX; ++slot) {
+    const uint32_t key = PERSIST_KEY_PRESET_FIRST + slot;
+    Preset *preset = &s_store.presets[slot];
+    if (persist_exists(key) && persist_read_data(key, preset, sizeof(*preset)) == (int)sizeof(*preset)) {
+      preset->name[PRESET_NAME_LENGTH - 1] = '\0';
+      s_store.filled[slot] = prv_valid(preset);
+    }
+  }
+}
+
+const Preset *preset_get(int slot) {
+  if (slot < 0 || slot >= PRESET_MAX || !s_store.filled[slot]) {
+    return NULL;
+  }
+  return &s_store.presets[slot];
+}
+
+int preset_next(int slot) {
+  for (int i = 1; i <= PRESET_MAX; ++i) {
+    const int candidate = (slot + i + PRESET_MAX) % PRESET_MAX;
+    if (s_store.filled[candidate]) {
+      return candidate;
+    }
+  }
+  return -1;
+}
+
+bool preset_apply(int slot, DiceModel *model) {
+  const Preset *preset = preset_get(slot);
+  if (!preset || !model) {
+    return false;
+  }
+  model_clear_groups(model);
+  for (int g = 0; g < preset->group_count; ++g) {
+    model_add_group(model, (DiceKind)preset->kinds[g], preset->counts[g]);
+  }
+  return true;
+}
+
+bool preset_store(int slot, const Preset *preset) {
+  if (slot < 0 || slot >= PRESET_MAX || !preset || !prv_valid(preset)) {
+    return false;
+  }
+  s_store.presets[slot] = *preset;
+  s_store.presets[slot].name[PRESET_NAME_LENGTH - 1] = '\0';
+  s_store.filled[slot] = true;
+  persist_write_data(PERSIST_KEY_PRESET_FIRST + slot, &s_store.presets[slot], sizeof(Preset));
+  return true;
+}
+
+void preset_delete(int slot) {
+  if (slot < 0 || slot >= PRESET_MAX) {
+    return;
+  }
+  s_store.filled[slot] = false;
+  persist_delete(PERSIST_KEY_PRESET_FIRST + slot);
+}
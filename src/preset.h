@@ -0,0 +1,30 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "dicecore/model.h"
+
+#define PRESET_MAX 8
+#define PRESET_NAME_LENGTH 16
+
+// A named dice configuration, edited on the phone's settings page.
+typedef struct {
+  char name[PRESET_NAME_LENGTH];
+  uint8_t group_count;
+  uint8_t kinds[MAX_DICE_GROUPS];
+  uint8_t counts[MAX_DICE_GROUPS];
+} Preset;
+
+// Reads every stored slot into RAM.
+void preset_init(void);
+
+// NULL for an empty slot.
+const Preset *preset_get(int slot);
+// First filled slot after `slot` (pass -1 to start), wrapping around; -1 if
+// there are none.
+int preset_next(int slot);
+// Replaces the model's groups with the preset's.
+bool preset_apply(int slot, DiceModel *model);
+
+bool preset_store(int slot, const Preset *preset);
+void preset_delete(int slot);
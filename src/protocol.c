@@ -0,0 +1,221 @@
+#include "protocol.h"
+
+#include <string.h>
+
+// GENERATED by tools/protocol_gen.py from protocol/dice_protocol.json -- do not edit.
+
+static inline void proto_put_u16(uint8_t *p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static inline void proto_put_u32(uint8_t *p, uint32_t v) {
+  p[0] = v & 0xFF;
+  p[1] = (v >> 8) & 0xFF;
+  p[2] = (v >> 16) & 0xFF;
+  p[3] = v >> 24;
+}
+
+static inline uint16_t proto_get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t proto_get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint16_t proto_roll_log_pack(const ProtoRollLog *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_ROLL_LOG_FIXED_SIZE + msg->records_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  if (msg->records_length > 0) {
+    memcpy(&out[offset], msg->records, msg->records_length);
+  }
+  offset += msg->records_length;
+  return offset;
+}
+
+bool proto_roll_log_unpack(const uint8_t *body, uint16_t length, ProtoRollLog *msg) {
+  uint16_t offset = 0;
+  msg->records = &body[offset];
+  msg->records_length = length - offset;
+  return true;
+}
+
+uint16_t proto_odds_request_pack(const ProtoOddsRequest *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_ODDS_REQUEST_FIXED_SIZE + msg->groups_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  proto_put_u32(&out[offset], msg->hash);
+  offset += 4;
+  out[offset++] = msg->group_count;
+  if (msg->groups_length > 0) {
+    memcpy(&out[offset], msg->groups, msg->groups_length);
+  }
+  offset += msg->groups_length;
+  return offset;
+}
+
+bool proto_odds_request_unpack(const uint8_t *body, uint16_t length, ProtoOddsRequest *msg) {
+  if (length < PROTO_ODDS_REQUEST_FIXED_SIZE) {
+    return false;
+  }
+  uint16_t offset = 0;
+  msg->hash = proto_get_u32(&body[offset]);
+  offset += 4;
+  msg->group_count = body[offset++];
+  msg->groups = &body[offset];
+  msg->groups_length = length - offset;
+  return true;
+}
+
+uint16_t proto_odds_reply_pack(const ProtoOddsReply *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_ODDS_REPLY_FIXED_SIZE > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  proto_put_u32(&out[offset], msg->hash);
+  offset += 4;
+  proto_put_u16(&out[offset], msg->min_total);
+  offset += 2;
+  proto_put_u16(&out[offset], msg->max_total);
+  offset += 2;
+  for (int i = 0; i < 32; ++i) {
+    proto_put_u16(&out[offset], msg->cdf[i]);
+    offset += 2;
+  }
+  return offset;
+}
+
+bool proto_odds_reply_unpack(const uint8_t *body, uint16_t length, ProtoOddsReply *msg) {
+  if (length < PROTO_ODDS_REPLY_FIXED_SIZE) {
+    return false;
+  }
+  uint16_t offset = 0;
+  msg->hash = proto_get_u32(&body[offset]);
+  offset += 4;
+  msg->min_total = proto_get_u16(&body[offset]);
+  offset += 2;
+  msg->max_total = proto_get_u16(&body[offset]);
+  offset += 2;
+  for (int i = 0; i < 32; ++i) {
+    msg->cdf[i] = proto_get_u16(&body[offset]);
+    offset += 2;
+  }
+  (void)offset;
+  return true;
+}
+
+uint16_t proto_history_request_pack(const ProtoHistoryRequest *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_HISTORY_REQUEST_FIXED_SIZE > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  proto_put_u16(&out[offset], msg->first);
+  offset += 2;
+  out[offset++] = msg->count;
+  return offset;
+}
+
+bool proto_history_request_unpack(const uint8_t *body, uint16_t length, ProtoHistoryRequest *msg) {
+  if (length < PROTO_HISTORY_REQUEST_FIXED_SIZE) {
+    return false;
+  }
+  uint16_t offset = 0;
+  msg->first = proto_get_u16(&body[offset]);
+  offset += 2;
+  msg->count = body[offset++];
+  (void)offset;
+  return true;
+}
+
+uint16_t proto_history_page_pack(const ProtoHistoryPage *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_HISTORY_PAGE_FIXED_SIZE + msg->entries_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  proto_put_u16(&out[offset], msg->first);
+  offset += 2;
+  proto_put_u16(&out[offset], msg->total);
+  offset += 2;
+  out[offset++] = msg->entry_count;
+  if (msg->entries_length > 0) {
+    memcpy(&out[offset], msg->entries, msg->entries_length);
+  }
+  offset += msg->entries_length;
+  return offset;
+}
+
+bool proto_history_page_unpack(const uint8_t *body, uint16_t length, ProtoHistoryPage *msg) {
+  if (length < PROTO_HISTORY_PAGE_FIXED_SIZE) {
+    return false;
+  }
+  uint16_t offset = 0;
+  msg->first = proto_get_u16(&body[offset]);
+  offset += 2;
+  msg->total = proto_get_u16(&body[offset]);
+  offset += 2;
+  msg->entry_count = body[offset++];
+  msg->entries = &body[offset];
+  msg->entries_length = length - offset;
+  return true;
+}
+
+uint16_t proto_preset_pack(const ProtoPreset *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_PRESET_FIXED_SIZE + msg->records_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  if (msg->records_length > 0) {
+    memcpy(&out[offset], msg->records, msg->records_length);
+  }
+  offset += msg->records_length;
+  return offset;
+}
+
+bool proto_preset_unpack(const uint8_t *body, uint16_t length, ProtoPreset *msg) {
+  uint16_t offset = 0;
+  msg->records = &body[offset];
+  msg->records_length = length - offset;
+  return true;
+}
+
+uint16_t proto_profile_pack(const ProtoProfile *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_PROFILE_FIXED_SIZE + msg->records_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  if (msg->records_length > 0) {
+    memcpy(&out[offset], msg->records, msg->records_length);
+  }
+  offset += msg->records_length;
+  return offset;
+}
+
+bool proto_profile_unpack(const uint8_t *body, uint16_t length, ProtoProfile *msg) {
+  uint16_t offset = 0;
+  msg->records = &body[offset];
+  msg->records_length = length - offset;
+  return true;
+}
+
+uint16_t proto_table_feed_pack(const ProtoTableFeed *msg, uint8_t *out, uint16_t size) {
+  if (PROTO_TABLE_FEED_FIXED_SIZE + msg->entries_length > size) {
+    return 0;
+  }
+  uint16_t offset = 0;
+  if (msg->entries_length > 0) {
+    memcpy(&out[offset], msg->entries, msg->entries_length);
+  }
+  offset += msg->entries_length;
+  return offset;
+}
+
+bool proto_table_feed_unpack(const uint8_t *body, uint16_t length, ProtoTableFeed *msg) {
+  uint16_t offset = 0;
+  msg->entries = &body[offset];
+  msg->entries_length = length - offset;
+  return true;
+}
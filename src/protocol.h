@@ -0,0 +1,125 @@
+#pragma once
+
+// GENERATED by tools/protocol_gen.py from protocol/dice_protocol.json -- do not edit.
+//
+// Fixed-width little-endian bodies for every message in the protocol. comm.c
+// frames them as [message id][body] in the PAYLOAD message key.
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  PROTO_MSG_APP_READY = 1,
+  PROTO_MSG_ROLL_LOG = 2,
+  PROTO_MSG_ODDS_REQUEST = 3,
+  PROTO_MSG_ODDS_REPLY = 4,
+  PROTO_MSG_HISTORY_REQUEST = 5,
+  PROTO_MSG_HISTORY_PAGE = 6,
+  PROTO_MSG_PRESET = 7,
+  PROTO_MSG_PROFILE = 8,
+  PROTO_MSG_TABLE_FEED = 9,
+} ProtoMessageId;
+
+// Completed rolls as framed records (src/frame.c), layout in src/roll_log.c. (watch to phone)
+#define PROTO_ROLL_LOG_FIXED_SIZE 0
+#define PROTO_ROLL_LOG_MERGEABLE 1
+typedef struct {
+  const uint8_t *records;
+  uint16_t records_length;
+} ProtoRollLog;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_roll_log_pack(const ProtoRollLog *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_roll_log_unpack(const uint8_t *body, uint16_t length, ProtoRollLog *msg);
+
+// Distribution wanted for a configuration; groups are [kind][count] pairs. (watch to phone)
+#define PROTO_ODDS_REQUEST_FIXED_SIZE 5
+typedef struct {
+  uint32_t hash;
+  uint8_t group_count;
+  const uint8_t *groups;
+  uint16_t groups_length;
+} ProtoOddsRequest;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_odds_request_pack(const ProtoOddsRequest *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_odds_request_unpack(const uint8_t *body, uint16_t length, ProtoOddsRequest *msg);
+
+// Downsampled CDF of a configuration's total, see src/odds.c. (phone to watch)
+#define PROTO_ODDS_REPLY_FIXED_SIZE 72
+typedef struct {
+  uint32_t hash;
+  uint16_t min_total;
+  uint16_t max_total;
+  uint16_t cdf[32];
+} ProtoOddsReply;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_odds_reply_pack(const ProtoOddsReply *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_odds_reply_unpack(const uint8_t *body, uint16_t length, ProtoOddsReply *msg);
+
+// A page of the phone-side history; index 0 is the newest roll. (watch to phone)
+#define PROTO_HISTORY_REQUEST_FIXED_SIZE 3
+typedef struct {
+  uint16_t first;
+  uint8_t count;
+} ProtoHistoryRequest;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_history_request_pack(const ProtoHistoryRequest *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_history_request_unpack(const uint8_t *body, uint16_t length, ProtoHistoryRequest *msg);
+
+// Summarized history entries, layout in src/history.c. (phone to watch)
+#define PROTO_HISTORY_PAGE_FIXED_SIZE 5
+typedef struct {
+  uint16_t first;
+  uint16_t total;
+  uint8_t entry_count;
+  const uint8_t *entries;
+  uint16_t entries_length;
+} ProtoHistoryPage;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_history_page_pack(const ProtoHistoryPage *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_history_page_unpack(const uint8_t *body, uint16_t length, ProtoHistoryPage *msg);
+
+// Changed preset slots, record layout in src/config_sync.c. (phone to watch)
+#define PROTO_PRESET_FIXED_SIZE 0
+typedef struct {
+  const uint8_t *records;
+  uint16_t records_length;
+} ProtoPreset;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_preset_pack(const ProtoPreset *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_preset_unpack(const uint8_t *body, uint16_t length, ProtoPreset *msg);
+
+// Changed profile timings, record layout in src/config_sync.c. (phone to watch)
+#define PROTO_PROFILE_FIXED_SIZE 0
+typedef struct {
+  const uint8_t *records;
+  uint16_t records_length;
+} ProtoProfile;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_profile_pack(const ProtoProfile *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_profile_unpack(const uint8_t *body, uint16_t length, ProtoProfile *msg);
+
+// Latest rolls at the table as framed records, layout in src/table_feed.c. (phone to watch)
+#define PROTO_TABLE_FEED_FIXED_SIZE 0
+typedef struct {
+  const uint8_t *entries;
+  uint16_t entries_length;
+} ProtoTableFeed;
+
+// Writes the body into `out`; returns its length, or 0 if it does not fit.
+uint16_t proto_table_feed_pack(const ProtoTableFeed *msg, uint8_t *out, uint16_t size);
+// Parses a body; trailing bytes point into `body`.
+bool proto_table_feed_unpack(const uint8_t *body, uint16_t length, ProtoTableFeed *msg);
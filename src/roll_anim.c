@@ -1,208 +1,398 @@
 #include "roll_anim.h"
 
-#include <stdlib.h>
 #include <string.h>
-#include <time.h>
+
+#include "dicecore/rng.h"
+#include "dicecore/roll_pool.h"
+#include "sched.h"
+
+// -----------------------------------------------------------------------------
+// ROLL ANIMATION MODULE
+// -----------------------------------------------------------------------------
+// Drives the "tumbling" previews for up to ROLL_ANIM_MAX_INSTANCES dice at once
+// on top of the system Animation framework, so frames arrive in step with
+// display refresh instead of through a chain of app timers. A single shared
+// Animation pumps frames; each die is a lightweight instance with its own
+// start time, callbacks, and a RollAnimTimeline planned up front (preview
+// values + delta-ms, ending in the final result). Frames only advance each
+// instance's cursor through its plan.
+//
+// All timing is measured against the wall clock (sched_now_ms), never
+// accumulated from nominal step sizes, so a late event loop drops frames
+// instead of stretching the roll. Callers may start an instance "in the past"
+// to stay on their own schedule.
+//
+// Safe tweaks:
+// - Timings and tick counts come from roll_profile.c; retune them there.
+// - Replace prv_decel_curve for a different "settling" feel.
 
 typedef struct {
   RollAnimCallbacks callbacks;
   void *callback_context;
-  AppTimer *timer;
-  int sides;
+  RollAnimTimeline timeline;
+  uint16_t generation;
   bool running;
-  int stage_index;
-  int stage_tick;
-  int stage_tick_limit;
-  bool in_final_stage;
-  bool in_hold_stage;
-  int final_tick_target;
-  int final_tick_count;
-  int final_tick_interval_ms;
-  int final_duration_ms;
-  int hold_duration_ms;
-  int pending_final_value;
-  bool has_pending_value;
+  bool settle_pending;
+  uint8_t frame_cursor;
+  int start_ms;
+  int next_frame_ms;
   int total_duration_ms;
-  int elapsed_ms;
-} RollAnimState;
-
-static RollAnimState s_state;
+} RollAnimInstance;
 
 typedef struct {
-  uint16_t duration_ms;
-  uint16_t step_ms;
-} RollAnimStage;
-
-static const RollAnimStage s_main_stages[] = {
-  {.duration_ms = 700, .step_ms = 40},
-  {.duration_ms = 500, .step_ms = 70},
-  {.duration_ms = 300, .step_ms = 110},
-};
-static const int s_main_stage_count = ARRAY_LENGTH(s_main_stages);
-static const int s_final_hold_ms = 350;
-static const int s_final_ticks_min = 3;
-static const int s_final_ticks_max = 4;
+  RollAnimFrameHandler on_frame;
+  void *frame_context;
+  Animation *animation;
+  SchedTimer *settle_timer;
+  RollAnimInstance instances[ROLL_ANIM_MAX_INSTANCES];
+} RollAnimEngine;
+
+static RollAnimEngine s_engine;
 
-static int prv_total_main_duration(void) {
-  int total = 0;
-  for (int i = 0; i < s_main_stage_count; ++i) {
-    total += s_main_stages[i].duration_ms;
+// Quadratic ease-out over the spin. Works in fixed point: (MAX - t)^2 stays
+// below 2^32 for t in [0, MAX].
+static uint32_t prv_decel_curve(int at_ms, int spin_ms) {
+  if (spin_ms <= 0) {
+    return ANIMATION_NORMALIZED_MAX;
+  }
+  uint32_t t = ((uint32_t)at_ms * ANIMATION_NORMALIZED_MAX) / spin_ms;
+  if (t > ANIMATION_NORMALIZED_MAX) {
+    t = ANIMATION_NORMALIZED_MAX;
+  }
+  const uint32_t remaining = ANIMATION_NORMALIZED_MAX - t;
+  return ANIMATION_NORMALIZED_MAX - (remaining * remaining) / ANIMATION_NORMALIZED_MAX;
+}
+
+// First millisecond at which the curve reaches `threshold`. The curve is
+// monotonic, so a binary search keeps it the single source of the pacing.
+static int prv_curve_time_for(uint32_t threshold, int spin_ms) {
+  int lo = 0;
+  int hi = spin_ms;
+  while (lo < hi) {
+    const int mid = (lo + hi) / 2;
+    if (prv_decel_curve(mid, spin_ms) >= threshold) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+// Previews are spread evenly along the curved progress, so the deceleration
+// curve alone decides how the flicker slows down. The tick count is picked at
+// random within the profile's range so consecutive rolls don't settle
+// identically.
+void roll_anim_build_timeline(RollAnimTimeline *timeline, int sides, const RollProfile *profile) {
+  if (!timeline || !profile) {
+    return;
+  }
+  memset(timeline, 0, sizeof(*timeline));
+
+  const int span = profile->spin_ticks_max - profile->spin_ticks_min + 1;
+  int tick_count = profile->spin_ticks_min + ((span > 0) ? (int)rng_global_bounded(span) : 0);
+  if (tick_count > ROLL_ANIM_MAX_FRAMES) {
+    tick_count = ROLL_ANIM_MAX_FRAMES;
+  }
+  if (tick_count < 1) {
+    tick_count = 1;
+  }
+
+  int previous_ms = 0;
+  for (int i = 0; i < tick_count; ++i) {
+    const uint32_t threshold = ((uint32_t)(i + 1) * ANIMATION_NORMALIZED_MAX) / tick_count;
+    const int at_ms = prv_curve_time_for(threshold, profile->spin_ms);
+    RollAnimFrame *frame = &timeline->frames[i];
+    frame->delta_ms = (uint16_t)(at_ms - previous_ms);
+    frame->value = (uint8_t)roll_pool_take(roll_pool_default(), sides);
+    previous_ms = at_ms;
+  }
+  timeline->frame_count = (uint8_t)tick_count;
+  timeline->hold_ms = profile->final_hold_ms;
+}
+
+int roll_anim_timeline_duration_ms(const RollAnimTimeline *timeline) {
+  if (!timeline) {
+    return 0;
+  }
+  int total = timeline->hold_ms;
+  for (int i = 0; i < timeline->frame_count; ++i) {
+    total += timeline->frames[i].delta_ms;
   }
   return total;
 }
 
-static int prv_random_roll(int sides) {
-  if (sides <= 0) {
+int roll_anim_timeline_result(const RollAnimTimeline *timeline) {
+  if (!timeline || timeline->frame_count == 0) {
     return 0;
   }
-  return (rand() % sides) + 1;
+  return timeline->frames[timeline->frame_count - 1].value;
+}
+
+// Handles pack the slot index with the slot's generation counter.
+static RollAnimHandle prv_make_handle(int index) {
+  return (s_engine.instances[index].generation << 8) | index;
 }
 
-static int prv_stage_tick_limit(int stage_index) {
-  if (stage_index < 0 || stage_index >= s_main_stage_count) {
-    return 1;
+static RollAnimInstance *prv_instance_for(RollAnimHandle handle) {
+  if (handle < 0) {
+    return NULL;
   }
-  const RollAnimStage *stage = &s_main_stages[stage_index];
-  const int ticks = stage->duration_ms / stage->step_ms;
-  return (ticks < 1) ? 1 : ticks;
+  const int index = handle & 0xFF;
+  if (index >= ROLL_ANIM_MAX_INSTANCES) {
+    return NULL;
+  }
+  RollAnimInstance *instance = &s_engine.instances[index];
+  if (instance->generation != (uint16_t)(handle >> 8)) {
+    return NULL;
+  }
+  return instance;
 }
 
-static void prv_finish_animation(void) {
-  s_state.running = false;
-  s_state.timer = NULL;
-  s_state.elapsed_ms = s_state.total_duration_ms;
+static void prv_emit_frame(RollAnimInstance *instance, int index) {
+  if (instance->callbacks.on_preview) {
+    instance->callbacks.on_preview(instance->timeline.frames[index].value, instance->callback_context);
+  }
 }
 
-static void prv_timer_handler(void *data) {
-  if (s_state.in_hold_stage) {
-    s_state.elapsed_ms += s_state.hold_duration_ms;
-    s_state.in_hold_stage = false;
-    if (s_state.callbacks.on_complete && s_state.has_pending_value) {
-      s_state.callbacks.on_complete(s_state.pending_final_value, s_state.callback_context);
+static void prv_complete(RollAnimInstance *instance) {
+  const int count = instance->timeline.frame_count;
+  if (instance->frame_cursor < count) {
+    instance->frame_cursor = count;
+    if (count > 0) {
+      prv_emit_frame(instance, count - 1);
     }
-    prv_finish_animation();
-    return;
   }
+  instance->running = false;
+  instance->settle_pending = false;
+  instance->generation++;
+  if (instance->callbacks.on_complete) {
+    instance->callbacks.on_complete(roll_anim_timeline_result(&instance->timeline), instance->callback_context);
+  }
+}
 
-  const bool playing_final = s_state.in_final_stage;
-  const int step_ms = playing_final ? s_state.final_tick_interval_ms : s_main_stages[s_state.stage_index].step_ms;
-  const int value = prv_random_roll(s_state.sides);
+// Moves the cursor past every frame that is due. Only the newest one is shown:
+// if the animation frame arrived late, the ones in between would never have
+// been visible anyway. Returns true when something was emitted.
+static bool prv_advance_to(RollAnimInstance *instance, int elapsed_ms) {
+  if (elapsed_ms >= instance->total_duration_ms) {
+    prv_complete(instance);
+    return true;
+  }
 
-  if (s_state.callbacks.on_preview) {
-    s_state.callbacks.on_preview(value, s_state.callback_context);
+  const int count = instance->timeline.frame_count;
+  int last_due = -1;
+  while (instance->frame_cursor < count && elapsed_ms >= instance->next_frame_ms) {
+    last_due = instance->frame_cursor++;
+    if (instance->frame_cursor < count) {
+      instance->next_frame_ms += instance->timeline.frames[instance->frame_cursor].delta_ms;
+    }
   }
+  if (last_due >= 0) {
+    prv_emit_frame(instance, last_due);
+    return true;
+  }
+  return false;
+}
 
-  s_state.elapsed_ms += step_ms;
+static bool prv_any_running(void) {
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    if (s_engine.instances[i].running) {
+      return true;
+    }
+  }
+  return false;
+}
 
-  if (!playing_final) {
-    s_state.stage_tick++;
-    if (s_state.stage_tick >= s_state.stage_tick_limit) {
-      s_state.stage_index++;
-      if (s_state.stage_index >= s_main_stage_count) {
-        s_state.in_final_stage = true;
-        s_state.final_tick_count = 0;
-      } else {
-        s_state.stage_tick = 0;
-        s_state.stage_tick_limit = prv_stage_tick_limit(s_state.stage_index);
-      }
+static void prv_stop_animation(void) {
+  Animation *animation = s_engine.animation;
+  s_engine.animation = NULL;
+  if (animation) {
+    animation_unschedule(animation);
+  }
+}
+
+// Shared tick: advances every running instance against the wall clock.
+static void prv_anim_update(Animation *animation, const AnimationProgress progress) {
+  const int now = sched_now_ms();
+
+  bool changed = false;
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    RollAnimInstance *instance = &s_engine.instances[i];
+    if (instance->running) {
+      changed |= prv_advance_to(instance, now - instance->start_ms);
     }
+  }
 
-    const int next_delay = s_state.in_final_stage ? s_state.final_tick_interval_ms : s_main_stages[s_state.stage_index].step_ms;
-    s_state.timer = app_timer_register(next_delay, prv_timer_handler, NULL);
-    return;
+  if (changed && s_engine.on_frame) {
+    s_engine.on_frame(s_engine.frame_context);
+  }
+  if (!prv_any_running()) {
+    prv_stop_animation();
   }
+}
 
-  s_state.final_tick_count++;
-  if (s_state.final_tick_count >= s_state.final_tick_target) {
-    s_state.pending_final_value = value;
-    s_state.has_pending_value = true;
-    s_state.in_hold_stage = true;
-    s_state.timer = app_timer_register(s_state.hold_duration_ms, prv_timer_handler, NULL);
-    return;
+static void prv_anim_stopped(Animation *animation, bool finished, void *context) {
+  // The framework destroys the animation once it stops, so drop our handle.
+  if (s_engine.animation == animation) {
+    s_engine.animation = NULL;
+  }
+}
+
+static const AnimationImplementation s_anim_impl = {
+  .update = prv_anim_update,
+};
+
+static bool prv_ensure_animation(void) {
+  if (s_engine.animation) {
+    return true;
   }
 
-  s_state.timer = app_timer_register(s_state.final_tick_interval_ms, prv_timer_handler, NULL);
+  Animation *animation = animation_create();
+  if (!animation) {
+    return false;
+  }
+  animation_set_duration(animation, ANIMATION_DURATION_INFINITE);
+  animation_set_curve(animation, AnimationCurveLinear);
+  animation_set_implementation(animation, &s_anim_impl);
+  animation_set_handlers(animation, (AnimationHandlers) {
+    .stopped = prv_anim_stopped,
+  }, NULL);
+
+  s_engine.animation = animation;
+  if (!animation_schedule(animation)) {
+    s_engine.animation = NULL;
+    animation_destroy(animation);
+    return false;
+  }
+  return true;
 }
 
-void roll_anim_init(const RollAnimCallbacks *callbacks, void *context) {
-  memset(&s_state, 0, sizeof(s_state));
-  if (callbacks) {
-    s_state.callbacks = *callbacks;
+// Settles the dice the framework refused to animate. Only those marked when
+// the timer was set are completed; a die started from one of their callbacks
+// gets its own pass.
+static void prv_settle_timer_cb(void *context) {
+  s_engine.settle_timer = NULL;
+  bool pending[ROLL_ANIM_MAX_INSTANCES];
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    pending[i] = s_engine.instances[i].running && s_engine.instances[i].settle_pending;
+    s_engine.instances[i].settle_pending = false;
+  }
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    if (pending[i] && s_engine.instances[i].running) {
+      prv_complete(&s_engine.instances[i]);
+    }
   }
-  s_state.callback_context = context;
-  s_state.stage_tick_limit = prv_stage_tick_limit(0);
-  srand(time(NULL));
+}
+
+void roll_anim_init(RollAnimFrameHandler on_frame, void *context) {
+  memset(&s_engine, 0, sizeof(s_engine));
+  s_engine.on_frame = on_frame;
+  s_engine.frame_context = context;
 }
 
 void roll_anim_deinit(void) {
-  if (s_state.timer) {
-    app_timer_cancel(s_state.timer);
-    s_state.timer = NULL;
-  }
-  s_state.running = false;
-}
-
-void roll_anim_start(int sides) {
-  if (s_state.running && s_state.timer) {
-    app_timer_cancel(s_state.timer);
-  }
-
-  s_state.sides = sides;
-  s_state.stage_index = 0;
-  s_state.stage_tick = 0;
-  s_state.stage_tick_limit = prv_stage_tick_limit(0);
-  s_state.in_final_stage = false;
-  s_state.in_hold_stage = false;
-  const int span = s_final_ticks_max - s_final_ticks_min + 1;
-  s_state.final_tick_target = s_final_ticks_min + ((span > 0) ? rand() % span : 0);
-  if (s_state.final_tick_target <= 0) {
-    s_state.final_tick_target = s_final_ticks_min;
-  }
-  s_state.final_duration_ms = 1500;
-  s_state.final_tick_interval_ms = s_state.final_duration_ms / s_state.final_tick_target;
-  if (s_state.final_tick_interval_ms <= 0) {
-    s_state.final_tick_interval_ms = 350;
-  }
-  s_state.final_tick_count = 0;
-  s_state.hold_duration_ms = s_final_hold_ms;
-  s_state.pending_final_value = 0;
-  s_state.has_pending_value = false;
-  s_state.elapsed_ms = 0;
-  s_state.total_duration_ms = prv_total_main_duration() + s_state.final_duration_ms + s_state.hold_duration_ms;
-  s_state.running = true;
-  s_state.timer = app_timer_register(s_main_stages[0].step_ms, prv_timer_handler, NULL);
-}
-
-void roll_anim_skip(void) {
-  if (!s_state.running) {
-    return;
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    s_engine.instances[i].running = false;
+  }
+  if (s_engine.settle_timer) {
+    sched_timer_cancel(s_engine.settle_timer);
+    s_engine.settle_timer = NULL;
+  }
+  prv_stop_animation();
+}
+
+RollAnimHandle roll_anim_start(int sides,
+                               const RollProfile *profile,
+                               const RollAnimCallbacks *callbacks,
+                               void *context) {
+  RollAnimTimeline timeline;
+  roll_anim_build_timeline(&timeline, sides, profile);
+  return roll_anim_start_timeline(&timeline, sched_now_ms(), callbacks, context);
+}
+
+RollAnimHandle roll_anim_start_timeline(const RollAnimTimeline *timeline,
+                                        int start_ms,
+                                        const RollAnimCallbacks *callbacks,
+                                        void *context) {
+  if (!timeline) {
+    return ROLL_ANIM_INVALID_HANDLE;
+  }
+
+  int index = -1;
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    if (!s_engine.instances[i].running) {
+      index = i;
+      break;
+    }
+  }
+  if (index < 0) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "No free roll animation slot");
+    return ROLL_ANIM_INVALID_HANDLE;
   }
 
-  if (s_state.timer) {
-    app_timer_cancel(s_state.timer);
-    s_state.timer = NULL;
+  RollAnimInstance *instance = &s_engine.instances[index];
+  instance->callbacks = callbacks ? *callbacks : (RollAnimCallbacks) {0};
+  instance->callback_context = context;
+  instance->timeline = *timeline;
+  instance->frame_cursor = 0;
+  instance->next_frame_ms = (timeline->frame_count > 0) ? timeline->frames[0].delta_ms : 0;
+  instance->total_duration_ms = roll_anim_timeline_duration_ms(timeline);
+  instance->start_ms = start_ms;
+  instance->running = true;
+  instance->settle_pending = false;
+  const RollAnimHandle handle = prv_make_handle(index);
+
+  // If the framework can't take the animation, settle the die on the next
+  // event loop pass so the caller never waits on a roll that will not finish.
+  // Completing it here would run the caller's callbacks in the middle of its
+  // own setup. Should the timer fail too, a skip still settles the die.
+  if (!prv_ensure_animation()) {
+    instance->settle_pending = true;
+    if (!s_engine.settle_timer) {
+      s_engine.settle_timer = sched_timer_register(0, prv_settle_timer_cb, NULL);
+    }
+    if (!s_engine.settle_timer) {
+      APP_LOG(APP_LOG_LEVEL_ERROR, "Roll animation unavailable; skip to settle");
+    }
+  }
+  return handle;
+}
+
+void roll_anim_skip(RollAnimHandle handle) {
+  RollAnimInstance *instance = prv_instance_for(handle);
+  if (!instance || !instance->running) {
+    return;
+  }
+  prv_complete(instance);
+  if (!prv_any_running()) {
+    prv_stop_animation();
   }
+}
 
-  const int result = prv_random_roll(s_state.sides);
-  if (s_state.callbacks.on_preview) {
-    s_state.callbacks.on_preview(result, s_state.callback_context);
+void roll_anim_skip_all(void) {
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    RollAnimInstance *instance = &s_engine.instances[i];
+    if (instance->running) {
+      prv_complete(instance);
+    }
   }
-  if (s_state.callbacks.on_complete) {
-    s_state.callbacks.on_complete(result, s_state.callback_context);
+  if (!prv_any_running()) {
+    prv_stop_animation();
   }
-  s_state.elapsed_ms = s_state.total_duration_ms;
-  prv_finish_animation();
 }
 
 bool roll_anim_is_running(void) {
-  return s_state.running;
+  return prv_any_running();
 }
 
-int roll_anim_progress_per_mille(void) {
-  if (s_state.total_duration_ms <= 0) {
-    return s_state.running ? 0 : 1000;
+int roll_anim_progress_per_mille(RollAnimHandle handle) {
+  RollAnimInstance *instance = prv_instance_for(handle);
+  if (!instance || !instance->running || instance->total_duration_ms <= 0) {
+    return 1000;
   }
-  int progress = (s_state.elapsed_ms * 1000) / s_state.total_duration_ms;
+  const int elapsed_ms = sched_now_ms() - instance->start_ms;
+  int progress = (elapsed_ms * 1000) / instance->total_duration_ms;
   if (progress > 1000) {
     progress = 1000;
   }
@@ -2,17 +2,59 @@
 
 #include <pebble.h>
 
+#include "roll_profile.h"
+
+#define ROLL_ANIM_MAX_FRAMES 32
+#define ROLL_ANIM_MAX_INSTANCES 8
+#define ROLL_ANIM_INVALID_HANDLE (-1)
+
 typedef void (*RollAnimValueHandler)(int value, void *context);
+typedef void (*RollAnimFrameHandler)(void *context);
+
+// Identifies one animating die. Handles go stale once the instance completes,
+// so an old handle can never touch a slot that has since been reused.
+typedef int RollAnimHandle;
 
 typedef struct {
   RollAnimValueHandler on_preview;
   RollAnimValueHandler on_complete;
 } RollAnimCallbacks;
 
-void roll_anim_init(const RollAnimCallbacks *callbacks, void *context);
+// One preview step: show `value` once `delta_ms` have passed since the previous
+// frame. The last frame of a timeline is the final result.
+typedef struct {
+  uint16_t delta_ms;
+  uint8_t value;
+} RollAnimFrame;
+
+// Everything a roll will show, decided up front so it can be replayed exactly.
+typedef struct {
+  RollAnimFrame frames[ROLL_ANIM_MAX_FRAMES];
+  uint8_t frame_count;
+  uint16_t hold_ms;
+} RollAnimTimeline;
+
+// `on_frame` runs once per shared animation frame after every instance has
+// advanced, so callers can redraw once instead of once per die.
+void roll_anim_init(RollAnimFrameHandler on_frame, void *context);
 void roll_anim_deinit(void);
 
-void roll_anim_start(int sides);
-void roll_anim_skip(void);
+void roll_anim_build_timeline(RollAnimTimeline *timeline, int sides, const RollProfile *profile);
+int roll_anim_timeline_duration_ms(const RollAnimTimeline *timeline);
+int roll_anim_timeline_result(const RollAnimTimeline *timeline);
+
+RollAnimHandle roll_anim_start(int sides,
+                               const RollProfile *profile,
+                               const RollAnimCallbacks *callbacks,
+                               void *context);
+// `start_ms` is on the sched_now_ms clock and may lie in the past; frames
+// that are already due are dropped rather than played late. Callbacks never
+// run from inside this call, so callers may start several dice in a loop.
+RollAnimHandle roll_anim_start_timeline(const RollAnimTimeline *timeline,
+                                        int start_ms,
+                                        const RollAnimCallbacks *callbacks,
+                                        void *context);
+void roll_anim_skip(RollAnimHandle handle);
+void roll_anim_skip_all(void);
 bool roll_anim_is_running(void);
-int roll_anim_progress_per_mille(void);
+int roll_anim_progress_per_mille(RollAnimHandle handle);
@@ -0,0 +1,58 @@
+#include "roll_log.h"
+
+#include "frame.h"
+#include "msg_queue.h"
+#include "protocol.h"
+
+// -----------------------------------------------------------------------------
+// ROLL LOG MODULE
+// -----------------------------------------------------------------------------
+// Exports every completed roll to the phone as packed bytes. A record is
+//
+//   [seq lo][seq hi][group count] then per group: [kind][count][result...]
+//
+// with one byte per result (the largest face is 99). Each record is wrapped in
+// a length-prefixed, CRC-checked frame (frame.c) and pushed to msg_queue as a
+// mergeable roll_log message, so rolls that pile up while the phone is away
+// or busy are coalesced into one message body per AppMessage and the
+// per-message overhead is paid once for several rolls.
+//
+// Safe tweaks:
+// - Buffering, retry and drop policy live in msg_queue.c.
+
+#define ROLL_LOG_HEADER_SIZE 3
+#define ROLL_LOG_MAX_RECORD (ROLL_LOG_HEADER_SIZE + MAX_DICE_GROUPS * (2 + MAX_RESULTS_PER_GROUP))
+
+static uint16_t s_next_seq;
+
+void roll_log_init(void) {
+  s_next_seq = 0;
+}
+
+void roll_log_record(const DiceModel *model) {
+  if (!model || model_group_count(model) == 0) {
+    return;
+  }
+
+  // The record is built after the widest length prefix and framed in place.
+  uint8_t frame[ROLL_LOG_MAX_RECORD + FRAME_OVERHEAD_MAX];
+  uint8_t *record = &frame[2];
+  uint16_t size = 0;
+  record[size++] = s_next_seq & 0xFF;
+  record[size++] = s_next_seq >> 8;
+  record[size++] = (uint8_t)model_group_count(model);
+  for (int g = 0; g < model_group_count(model); ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    record[size++] = (uint8_t)group->die_def_index;
+    record[size++] = (uint8_t)group->count;
+    for (int d = 0; d < group->count; ++d) {
+      record[size++] = (uint8_t)group->results[d];
+    }
+  }
+
+  const uint16_t framed = frame_encode(record, size, frame, sizeof(frame));
+  if (!msg_queue_push(PROTO_MSG_ROLL_LOG, frame, framed, MSG_QUEUE_MERGEABLE)) {
+    APP_LOG(APP_LOG_LEVEL_WARNING, "Roll log dropped roll %u", s_next_seq);
+  }
+  s_next_seq++;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "dicecore/model.h"
+
+void roll_log_init(void);
+
+// Queues the finished roll for export to the phone. Never blocks: the record is
+// copied into msg_queue and sent whenever AppMessage is free.
+void roll_log_record(const DiceModel *model);
@@ -0,0 +1,122 @@
+#include "roll_profile.h"
+
+#include "persist_keys.h"
+
+// -----------------------------------------------------------------------------
+// ROLL PROFILE MODULE
+// -----------------------------------------------------------------------------
+// Data tables for how long a roll takes. The state machine and roll_anim.c read
+// the active profile instead of hard-coding timings, and the user's choice is
+// kept in persistent storage between launches. Timings of animated profiles
+// can be overridden from the phone's settings page; overrides are persisted
+// per profile and applied on load.
+//
+// Safe tweaks:
+// - Retune the numbers in s_profiles; "classic" matches the original pacing.
+// - ROLL_PROFILE_SPIN_MAX_MS bounds what the settings page may ask for.
+// - Add a profile by extending RollProfileId and this table together.
+
+#define ROLL_PROFILE_SPIN_MAX_MS 10000
+
+static RollProfile s_profiles[ROLL_PROFILE_COUNT] = {
+  [ROLL_PROFILE_INSTANT] = {
+    .label = "instant",
+    .animated = false,
+  },
+  [ROLL_PROFILE_FAST] = {
+    .label = "fast",
+    .animated = true,
+    .spin_ms = 380,
+    .spin_ticks_min = 7,
+    .spin_ticks_max = 8,
+    .final_hold_ms = 120,
+    .result_hold_ms = 300,
+  },
+  [ROLL_PROFILE_CLASSIC] = {
+    .label = "classic",
+    .animated = true,
+    .spin_ms = 3000,
+    .spin_ticks_min = 29,
+    .spin_ticks_max = 30,
+    .final_hold_ms = 350,
+    .result_hold_ms = 1000,
+  },
+};
+
+static const RollProfileId s_default_profile = ROLL_PROFILE_CLASSIC;
+
+const RollProfile *roll_profile_get(RollProfileId id) {
+  if (id < 0 || id >= ROLL_PROFILE_COUNT) {
+    id = s_default_profile;
+  }
+  return &s_profiles[id];
+}
+
+RollProfileId roll_profile_next(RollProfileId id) {
+  return (RollProfileId)((id + 1) % ROLL_PROFILE_COUNT);
+}
+
+// Stretches (pace > 100) or compresses (pace < 100) every duration of a
+// profile while keeping its tick counts, so the roll keeps its shape.
+void roll_profile_paced(const RollProfile *base, int pace_pct, RollProfile *out) {
+  if (!base || !out) {
+    return;
+  }
+  *out = *base;
+  if (pace_pct <= 0 || pace_pct == 100) {
+    return;
+  }
+  out->spin_ms = (uint16_t)((base->spin_ms * pace_pct) / 100);
+  out->final_hold_ms = (uint16_t)((base->final_hold_ms * pace_pct) / 100);
+  out->result_hold_ms = (uint16_t)((base->result_hold_ms * pace_pct) / 100);
+}
+
+static bool prv_timing_valid(const RollProfileTiming *timing) {
+  return timing->spin_ms <= ROLL_PROFILE_SPIN_MAX_MS && timing->spin_ticks_min >= 1 &&
+         timing->spin_ticks_min <= timing->spin_ticks_max && timing->final_hold_ms <= ROLL_PROFILE_SPIN_MAX_MS &&
+         timing->result_hold_ms <= ROLL_PROFILE_SPIN_MAX_MS;
+}
+
+static void prv_apply_timing(RollProfile *profile, const RollProfileTiming *timing) {
+  profile->spin_ms = timing->spin_ms;
+  profile->spin_ticks_min = timing->spin_ticks_min;
+  profile->spin_ticks_max = timing->spin_ticks_max;
+  profile->final_hold_ms = timing->final_hold_ms;
+  profile->result_hold_ms = timing->result_hold_ms;
+}
+
+static void prv_load_timings(void) {
+  for (int id = 0; id < ROLL_PROFILE_COUNT; ++id) {
+    const uint32_t key = PERSIST_KEY_PROFILE_TIMING_FIRST + id;
+    RollProfileTiming timing;
+    if (s_profiles[id].animated && persist_exists(key) &&
+        persist_read_data(key, &timing, sizeof(timing)) == (int)sizeof(timing) && prv_timing_valid(&timing)) {
+      prv_apply_timing(&s_profiles[id], &timing);
+    }
+  }
+}
+
+RollProfileId roll_profile_load(void) {
+  prv_load_timings();
+  if (!persist_exists(PERSIST_KEY_ROLL_PROFILE)) {
+    return s_default_profile;
+  }
+  const int32_t stored = persist_read_int(PERSIST_KEY_ROLL_PROFILE);
+  if (stored < 0 || stored >= ROLL_PROFILE_COUNT) {
+    return s_default_profile;
+  }
+  return (RollProfileId)stored;
+}
+
+void roll_profile_save(RollProfileId id) {
+  persist_write_int(PERSIST_KEY_ROLL_PROFILE, id);
+}
+
+bool roll_profile_set_timing(RollProfileId id, const RollProfileTiming *timing) {
+  if (id < 0 || id >= ROLL_PROFILE_COUNT || !timing || !s_profiles[id].animated || !prv_timing_valid(timing)) {
+    return false;
+  }
+  prv_apply_timing(&s_profiles[id], timing);
+  persist_write_data(PERSIST_KEY_PROFILE_TIMING_FIRST + id, timing, sizeof(*timing));
+  return true;
+}
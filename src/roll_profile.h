@@ -0,0 +1,41 @@
+#pragma once
+
+#include <pebble.h>
+
+typedef enum {
+  ROLL_PROFILE_INSTANT,
+  ROLL_PROFILE_FAST,
+  ROLL_PROFILE_CLASSIC,
+  ROLL_PROFILE_COUNT
+} RollProfileId;
+
+// Pacing for one way of rolling. `spin_ms`/`spin_ticks_*`/`final_hold_ms`
+// shape each die's animation, `result_hold_ms` is the pause between batches.
+typedef struct {
+  const char *label;
+  bool animated;
+  uint16_t spin_ms;
+  uint8_t spin_ticks_min;
+  uint8_t spin_ticks_max;
+  uint16_t final_hold_ms;
+  uint16_t result_hold_ms;
+} RollProfile;
+
+// The tunable part of a profile, as the phone's settings page sends it and as
+// it is persisted.
+typedef struct {
+  uint16_t spin_ms;
+  uint8_t spin_ticks_min;
+  uint8_t spin_ticks_max;
+  uint16_t final_hold_ms;
+  uint16_t result_hold_ms;
+} RollProfileTiming;
+
+const RollProfile *roll_profile_get(RollProfileId id);
+RollProfileId roll_profile_next(RollProfileId id);
+void roll_profile_paced(const RollProfile *base, int pace_pct, RollProfile *out);
+// Loads the selected profile id, and any timing overrides into the table.
+RollProfileId roll_profile_load(void);
+void roll_profile_save(RollProfileId id);
+// Overrides (and persists) an animated profile's timings; false if rejected.
+bool roll_profile_set_timing(RollProfileId id, const RollProfileTiming *timing);
@@ -0,0 +1,180 @@
+#include "sched.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// SCHEDULER MODULE
+// -----------------------------------------------------------------------------
+// Multiplexes every app-level timer onto a single AppTimer. Pending timers sit
+// in a fixed pool, linked in deadline order; the AppTimer is always armed for
+// the earliest one, and each wakeup services every timer that is due (or due
+// within SCHED_COALESCE_MS) before re-arming once.
+//
+// Safe tweaks:
+// - Raise SCHED_MAX_TIMERS in sched.h if registrations start failing.
+// - Widen SCHED_COALESCE_MS to merge more nearby deadlines into one wakeup.
+
+#define SCHED_COALESCE_MS 10
+#define SCHED_NONE (-1)
+
+struct SchedTimer {
+  int deadline_ms;
+  SchedCallback callback;
+  void *data;
+  int8_t next;
+  bool in_use;
+};
+
+typedef struct {
+  SchedTimer timers[SCHED_MAX_TIMERS];
+  int8_t head;
+  AppTimer *app_timer;
+  time_t epoch_s;
+  bool servicing;
+} Scheduler;
+
+static Scheduler s_sched;
+
+static void prv_arm(void);
+
+int sched_now_ms(void) {
+  time_t seconds = 0;
+  uint16_t millis = 0;
+  time_ms(&seconds, &millis);
+  return (int)(seconds - s_sched.epoch_s) * 1000 + millis;
+}
+
+static int prv_index_of(const SchedTimer *timer) {
+  if (!timer || timer < s_sched.timers || timer >= s_sched.timers + SCHED_MAX_TIMERS) {
+    return SCHED_NONE;
+  }
+  return (int)(timer - s_sched.timers);
+}
+
+static void prv_unlink(int index) {
+  int8_t *link = &s_sched.head;
+  while (*link != SCHED_NONE) {
+    if (*link == index) {
+      *link = s_sched.timers[index].next;
+      break;
+    }
+    link = &s_sched.timers[*link].next;
+  }
+  s_sched.timers[index].next = SCHED_NONE;
+}
+
+// Equal deadlines keep registration order.
+static void prv_insert_sorted(int index) {
+  const int deadline = s_sched.timers[index].deadline_ms;
+  int8_t *link = &s_sched.head;
+  while (*link != SCHED_NONE && s_sched.timers[*link].deadline_ms <= deadline) {
+    link = &s_sched.timers[*link].next;
+  }
+  s_sched.timers[index].next = *link;
+  *link = (int8_t)index;
+}
+
+static void prv_app_timer_cb(void *data) {
+  s_sched.app_timer = NULL;
+  s_sched.servicing = true;
+
+  // Pop from the head each time: callbacks are free to register or cancel.
+  while (s_sched.head != SCHED_NONE) {
+    const int index = s_sched.head;
+    SchedTimer *timer = &s_sched.timers[index];
+    if (timer->deadline_ms > sched_now_ms() + SCHED_COALESCE_MS) {
+      break;
+    }
+    const SchedCallback callback = timer->callback;
+    void *callback_data = timer->data;
+    s_sched.head = timer->next;
+    memset(timer, 0, sizeof(*timer));
+    timer->next = SCHED_NONE;
+    if (callback) {
+      callback(callback_data);
+    }
+  }
+
+  s_sched.servicing = false;
+  prv_arm();
+}
+
+static void prv_arm(void) {
+  if (s_sched.servicing) {
+    return;
+  }
+  if (s_sched.head == SCHED_NONE) {
+    if (s_sched.app_timer) {
+      app_timer_cancel(s_sched.app_timer);
+      s_sched.app_timer = NULL;
+    }
+    return;
+  }
+
+  int delay_ms = s_sched.timers[s_sched.head].deadline_ms - sched_now_ms();
+  if (delay_ms < 0) {
+    delay_ms = 0;
+  }
+  if (s_sched.app_timer && app_timer_reschedule(s_sched.app_timer, delay_ms)) {
+    return;
+  }
+  s_sched.app_timer = app_timer_register(delay_ms, prv_app_timer_cb, NULL);
+}
+
+void sched_init(void) {
+  memset(&s_sched, 0, sizeof(s_sched));
+  s_sched.head = SCHED_NONE;
+  for (int i = 0; i < SCHED_MAX_TIMERS; ++i) {
+    s_sched.timers[i].next = SCHED_NONE;
+  }
+  s_sched.epoch_s = time(NULL);
+}
+
+void sched_deinit(void) {
+  if (s_sched.app_timer) {
+    app_timer_cancel(s_sched.app_timer);
+    s_sched.app_timer = NULL;
+  }
+  s_sched.head = SCHED_NONE;
+  for (int i = 0; i < SCHED_MAX_TIMERS; ++i) {
+    s_sched.timers[i].in_use = false;
+  }
+}
+
+SchedTimer *sched_timer_register(uint32_t delay_ms, SchedCallback callback, void *data) {
+  return sched_timer_register_at(sched_now_ms() + (int)delay_ms, callback, data);
+}
+
+SchedTimer *sched_timer_register_at(int deadline_ms, SchedCallback callback, void *data) {
+  int index = SCHED_NONE;
+  for (int i = 0; i < SCHED_MAX_TIMERS; ++i) {
+    if (!s_sched.timers[i].in_use) {
+      index = i;
+      break;
+    }
+  }
+  if (index == SCHED_NONE) {
+    APP_LOG(APP_LOG_LEVEL_ERROR, "Scheduler full");
+    return NULL;
+  }
+
+  SchedTimer *timer = &s_sched.timers[index];
+  timer->deadline_ms = deadline_ms;
+  timer->callback = callback;
+  timer->data = data;
+  timer->in_use = true;
+  prv_insert_sorted(index);
+  prv_arm();
+  return timer;
+}
+
+void sched_timer_cancel(SchedTimer *timer) {
+  const int index = prv_index_of(timer);
+  if (index == SCHED_NONE || !timer->in_use) {
+    return;
+  }
+  prv_unlink(index);
+  memset(timer, 0, sizeof(*timer));
+  timer->next = SCHED_NONE;
+  prv_arm();
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <pebble.h>
+
+#define SCHED_MAX_TIMERS 8
+
+typedef void (*SchedCallback)(void *data);
+
+// Opaque handle, valid until the timer fires or is cancelled (same contract as
+// AppTimer: clear your copy inside the callback).
+typedef struct SchedTimer SchedTimer;
+
+void sched_init(void);
+void sched_deinit(void);
+
+// Milliseconds since sched_init on the wall clock; the shared time base for
+// everything that schedules work.
+int sched_now_ms(void);
+
+SchedTimer *sched_timer_register(uint32_t delay_ms, SchedCallback callback, void *data);
+SchedTimer *sched_timer_register_at(int deadline_ms, SchedCallback callback, void *data);
+void sched_timer_cancel(SchedTimer *timer);
@@ -0,0 +1,101 @@
+#include "shake.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "entropy.h"
+
+// -----------------------------------------------------------------------------
+// SHAKE MODULE
+// -----------------------------------------------------------------------------
+// Detects a "shake to roll" gesture from batched, low-rate accelerometer data.
+// Samples arrive SHAKE_BATCH_SIZE at a time at 10Hz, so the app wakes only a
+// couple of times per second while listening, and the detector only sums the
+// jerk (sample-to-sample change) across each batch.
+//
+// Safe tweaks:
+// - Lower SHAKE_MIN_JERK if shakes are missed, raise it for false triggers.
+// - SHAKE_STRONG_JERK is where the reported energy saturates at 1000.
+
+#define SHAKE_SAMPLING_RATE ACCEL_SAMPLING_10HZ
+#define SHAKE_BATCH_SIZE 5
+#define SHAKE_MIN_JERK 2500
+#define SHAKE_STRONG_JERK 12000
+
+typedef struct {
+  ShakeHandler handler;
+  void *context;
+  bool enabled;
+  bool has_last_sample;
+  AccelData last_sample;
+} ShakeState;
+
+static ShakeState s_shake;
+
+static int prv_jerk(const AccelData *a, const AccelData *b) {
+  return abs(a->x - b->x) + abs(a->y - b->y) + abs(a->z - b->z);
+}
+
+static void prv_accel_data_handler(AccelData *data, uint32_t num_samples) {
+  if (!s_shake.enabled || num_samples == 0) {
+    return;
+  }
+  // One sample per batch is plenty to keep the pool stirred.
+  entropy_add_accel(&data[num_samples - 1]);
+
+  int jerk = 0;
+  for (uint32_t i = 0; i < num_samples; ++i) {
+    // Readings taken while the motor runs are noise, not a gesture.
+    if (data[i].did_vibrate) {
+      s_shake.has_last_sample = false;
+      continue;
+    }
+    if (s_shake.has_last_sample) {
+      jerk += prv_jerk(&data[i], &s_shake.last_sample);
+    }
+    s_shake.last_sample = data[i];
+    s_shake.has_last_sample = true;
+  }
+
+  if (jerk < SHAKE_MIN_JERK) {
+    return;
+  }
+
+  int energy = ((jerk - SHAKE_MIN_JERK) * 1000) / (SHAKE_STRONG_JERK - SHAKE_MIN_JERK);
+  if (energy > 1000) {
+    energy = 1000;
+  }
+  // Start over so one long shake doesn't fire on every following batch.
+  s_shake.has_last_sample = false;
+  if (s_shake.handler) {
+    s_shake.handler(energy, s_shake.context);
+  }
+}
+
+void shake_init(ShakeHandler handler, void *context) {
+  memset(&s_shake, 0, sizeof(s_shake));
+  s_shake.handler = handler;
+  s_shake.context = context;
+}
+
+void shake_deinit(void) {
+  shake_set_enabled(false);
+}
+
+void shake_set_enabled(bool enabled) {
+  if (enabled == s_shake.enabled) {
+    return;
+  }
+  s_shake.enabled = enabled;
+  s_shake.has_last_sample = false;
+  if (enabled) {
+    accel_data_service_subscribe(SHAKE_BATCH_SIZE, prv_accel_data_handler);
+    accel_service_set_sampling_rate(SHAKE_SAMPLING_RATE);
+  } else {
+    accel_data_service_unsubscribe();
+  }
+}
+
+bool shake_is_enabled(void) {
+  return s_shake.enabled;
+}
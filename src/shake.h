@@ -0,0 +1,15 @@
+#pragma once
+
+#include <pebble.h>
+
+// `energy_per_mille` runs from 0 (barely past the threshold) to 1000 (a hard
+// shake), so callers can scale their response to it.
+typedef void (*ShakeHandler)(int energy_per_mille, void *context);
+
+void shake_init(ShakeHandler handler, void *context);
+void shake_deinit(void);
+
+// Subscribes to (or releases) the accelerometer; only keep it on while a shake
+// can actually do something.
+void shake_set_enabled(bool enabled);
+bool shake_is_enabled(void);
@@ -3,8 +3,21 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "model.h"
+#include "config_sync.h"
+#include "dicecore/model.h"
+#include "dicecore/rng.h"
+#include "dicecore/roll_pool.h"
+#include "entropy.h"
+#include "history.h"
+#include "odds.h"
+#include "persist_keys.h"
+#include "preset.h"
 #include "roll_anim.h"
+#include "roll_log.h"
+#include "roll_profile.h"
+#include "sched.h"
+#include "shake.h"
+#include "table_feed.h"
 #include "ui.h"
 
 // -----------------------------------------------------------------------------
@@ -12,16 +25,43 @@
 // -----------------------------------------------------------------------------
 // Owns the app-wide state machine, button handlers, and roll animation flow.
 // ui.c never manipulates UI state by itself: it receives only UiRenderData.
+// Dice of the same group tumble together in batches of up to
+// ROLL_ANIM_MAX_INSTANCES, sharing one animation clock. Batches are placed on a
+// wall-clock schedule (next_batch_at_ms): a late timer starts the next batch
+// back-dated to its slot, so lateness is absorbed instead of adding up.
 //
 // Safe tweaks:
 // - Update the hint macros below to change button labels per screen.
-// - Adjust RESULT_HOLD_MS if you want longer/shorter pauses between dice.
+// - Pauses between batches come from the active profile (roll_profile.c).
+// - Tune SHAKE_PACE_* to change how much shake strength speeds up a roll.
+// - Shake-to-roll listens on the add-group prompt only; move it in
+//   prv_state_services (every extra state is 10Hz accelerometer time).
+// - ROLL_POOL_* set how quickly the pool recovers between batches.
 // - Extend the switch blocks in prv_render or state_handle_* when adding states.
 
-#define RESULT_HOLD_MS 1000
+// A gentle shake lingers on the tumble, a hard one settles quickly.
+#define SHAKE_PACE_GENTLE_PCT 130
+#define SHAKE_PACE_HARD_PCT 60
+#define DEFAULT_PACE_PCT 100
+// Shakes this soon after a state change are the tail of the gesture (or the
+// roll) that caused it, not a new request.
+#define SHAKE_ARM_DELAY_MS 1500
+
+// Random values are pre-drawn for the group being rolled: a batch tops the
+// pool up to everything its timelines can take before it starts, then small
+// slices refill it between animation frames for the next batch.
+#define ROLL_POOL_SLICE 32
+#define ROLL_POOL_SLICE_DELAY_MS 20
+
+typedef enum {
+  STATE_SERVICE_TAP = 1 << 0,
+  STATE_SERVICE_SHAKE = 1 << 1,
+} StateService;
+#define STATE_SERVICE_COUNT 2
 
 #define HINT_REROLL "RE"
 #define HINT_SELECT_HOLD_ROLL "Sel/\nHold\nRoll"
+#define HINT_SELECT_SHAKE_ROLL "Sel/\nShake\nRoll"
 #define HINT_SELECT_SKIP "Tap\nSkip"
 #define HINT_SCROLL "v"
 #define HINT_BOTTOM_CLEAR "Clr"
@@ -30,30 +70,44 @@
 #define HINT_ARROW_DOWN "v"
 #define HINT_PLUS "+"
 #define HINT_MINUS "-"
+#define HINT_TABLE "Tbl"
+#define HINT_HISTORY "Hist"
 
 // All mutable runtime info lives in this struct so we can reason about state
 // transitions and animation timing in one place.
 typedef struct {
   AppState current_state;
   DiceModel model;
-  int rolling_value;
+  int batch_count;
+  int batch_completed;
+  int batch_values[ROLL_ANIM_MAX_INSTANCES];
+  RollAnimHandle batch_handles[ROLL_ANIM_MAX_INSTANCES];
+  int batch_end_ms;
+  int next_batch_at_ms;
   bool skip_requested;
   bool initialized;
   bool quick_roll_active;
   bool has_saved_model;
   DiceModel saved_model;
-  AppTimer *result_hold_timer;
+  SchedTimer *result_hold_timer;
+  SchedTimer *pool_refill_timer;
   bool confirm_clear_prompt;
   DiceKind roll_kind;
   int roll_range;
-  bool roll_zero_based;
-  bool roll_tens_mode;
+  RollProfileId profile_id;
+  int pace_pct;
+  bool shake_to_roll;
+  int state_entered_ms;
+  int preset_slot;
+  int table_top;
+  uint8_t active_services;
+  AppState services_state;
 } StateContext;
 
 static StateContext s_ctx;
 
 static void prv_render(void);
-static void prv_start_next_die(void);
+static void prv_start_next_batch(void);
 static void prv_finish_roll(void);
 static void prv_begin_roll(void);
 static void prv_restore_saved_model(void);
@@ -63,8 +117,8 @@ static void prv_result_hold_timer_cb(void *context);
 static void prv_after_result(void);
 static bool prv_rewind_last_group(void);
 static void prv_prepare_roll_metadata(void);
-static int prv_normalize_roll_value(int raw_value);
 static int prv_random_result_value(void);
+static bool prv_state_accepts_shake(AppState state);
 
 static const char *prv_state_name(AppState state) {
   switch (state) {
@@ -78,6 +132,10 @@ static const char *prv_state_name(AppState state) {
       return "ROLLING";
     case RESULTS:
       return "RESULTS";
+    case HISTORY:
+      return "HISTORY";
+    case TABLE_FEED:
+      return "TABLE_FEED";
   }
   return "UNKNOWN";
 }
@@ -112,33 +170,55 @@ static void prv_prepare_roll_metadata(void) {
   if (s_ctx.roll_range <= 0) {
     s_ctx.roll_range = 1;
   }
-  s_ctx.roll_zero_based = model_kind_zero_based(s_ctx.roll_kind);
-  s_ctx.roll_tens_mode = model_kind_tens_mode(s_ctx.roll_kind);
+
+  RollPool *pool = roll_pool_default();
+  if (pool->range != s_ctx.roll_range) {
+    roll_pool_reset(pool, s_ctx.roll_range);
+  }
 }
 
-static int prv_normalize_roll_value(int raw_value) {
-  if (raw_value <= 0) {
-    return 0;
+// Every preview frame (the last one is the result) comes from the pool, so a
+// batch can take up to `count` times the profile's longest spin. Whatever the
+// idle slices haven't drawn yet is drawn now, before setup starts popping.
+static void prv_prime_pool_for_batch(int count, const RollProfile *profile) {
+  int ticks = profile->spin_ticks_max;
+  if (ticks > ROLL_ANIM_MAX_FRAMES) {
+    ticks = ROLL_ANIM_MAX_FRAMES;
   }
-  int value = raw_value;
-  if (s_ctx.roll_zero_based) {
-    value = raw_value - 1;
-    if (value < 0) {
-      value = 0;
-    }
+  RollPool *pool = roll_pool_default();
+  const int missing = count * ticks - pool->level;
+  if (missing > 0) {
+    roll_pool_fill(pool, missing);
+  }
+}
+
+static void prv_pool_refill_cb(void *context) {
+  s_ctx.pool_refill_timer = NULL;
+  RollPool *pool = roll_pool_default();
+  roll_pool_fill(pool, ROLL_POOL_SLICE);
+  if (!roll_pool_is_full(pool) && s_ctx.current_state == ROLLING) {
+    s_ctx.pool_refill_timer = sched_timer_register(ROLL_POOL_SLICE_DELAY_MS, prv_pool_refill_cb, NULL);
   }
-  if (s_ctx.roll_tens_mode) {
-    value *= 10;
+}
+
+static void prv_schedule_pool_refill(void) {
+  if (!s_ctx.pool_refill_timer && !roll_pool_is_full(roll_pool_default())) {
+    s_ctx.pool_refill_timer = sched_timer_register(ROLL_POOL_SLICE_DELAY_MS, prv_pool_refill_cb, NULL);
+  }
+}
+
+static void prv_cancel_pool_refill(void) {
+  if (s_ctx.pool_refill_timer) {
+    sched_timer_cancel(s_ctx.pool_refill_timer);
+    s_ctx.pool_refill_timer = NULL;
   }
-  return value;
 }
 
 static int prv_random_result_value(void) {
   if (s_ctx.roll_range <= 0) {
     return 0;
   }
-  const int raw = (rand() % s_ctx.roll_range) + 1;
-  return prv_normalize_roll_value(raw);
+  return model_kind_face_value(s_ctx.roll_kind, roll_pool_take(roll_pool_default(), s_ctx.roll_range));
 }
 
 // Pushes state & hint data to ui.c so only this file needs to be touched when
@@ -147,10 +227,15 @@ static int prv_random_result_value(void) {
 static void prv_render(void) {
   UiRenderData view = {
     .state = s_ctx.current_state,
-    .rolling_value = s_ctx.rolling_value,
-    .anim_progress_per_mille = roll_anim_progress_per_mille(),
+    .rolling_count = s_ctx.batch_count,
+    .anim_progress_per_mille = roll_anim_progress_per_mille(s_ctx.batch_handles[0]),
     .confirm_clear_prompt = s_ctx.confirm_clear_prompt,
+    .profile_label = roll_profile_get(s_ctx.profile_id)->label,
+    .total_percentile = ODDS_PENDING,
   };
+  const Preset *preset = preset_get(s_ctx.preset_slot);
+  view.preset_name = preset ? preset->name : NULL;
+  memcpy(view.rolling_values, s_ctx.batch_values, sizeof(view.rolling_values));
   prv_set_hints(&view, "", "", "");
 
   switch (s_ctx.current_state) {
@@ -162,7 +247,8 @@ static void prv_render(void) {
       break;
     case ADD_GROUP_PROMPT:
       if (model_has_groups(&s_ctx.model)) {
-        prv_set_hints(&view, HINT_ARROW_UP, HINT_SELECT_HOLD_ROLL, s_ctx.confirm_clear_prompt ? HINT_CONFIRM : HINT_BOTTOM_CLEAR);
+        prv_set_hints(&view, HINT_ARROW_UP, prv_state_accepts_shake(ADD_GROUP_PROMPT) ? HINT_SELECT_SHAKE_ROLL : HINT_SELECT_HOLD_ROLL,
+                      s_ctx.confirm_clear_prompt ? HINT_CONFIRM : HINT_BOTTOM_CLEAR);
       }
       break;
     case ROLLING:
@@ -170,14 +256,120 @@ static void prv_render(void) {
       break;
     case RESULTS:
       prv_set_hints(&view, HINT_REROLL, HINT_SELECT_HOLD_ROLL, HINT_SCROLL);
+      view.total_percentile = odds_total_percentile(&s_ctx.model, model_roll_total(&s_ctx.model));
+      break;
+    case HISTORY:
+      prv_set_hints(&view, HINT_ARROW_UP, HINT_TABLE, HINT_ARROW_DOWN);
+      view.history_entry = history_current();
+      view.history_index = history_cursor();
+      view.history_count = history_count();
+      break;
+    case TABLE_FEED:
+      prv_set_hints(&view, HINT_ARROW_UP, HINT_HISTORY, HINT_ARROW_DOWN);
+      view.table_top = s_ctx.table_top;
+      view.table_count = table_feed_count();
       break;
   }
 
   ui_render(&view, &s_ctx.model);
 }
 
+// The user's profile, stretched or compressed by the pace of the current roll.
+static const RollProfile *prv_active_profile(RollProfile *storage) {
+  roll_profile_paced(roll_profile_get(s_ctx.profile_id), s_ctx.pace_pct, storage);
+  return storage;
+}
+
+// ----- Service subscriptions ------------------------------------------------
+// Event services are owned by the state machine: each state lists what it
+// reacts to, and everything else is released on entry so sensors only draw
+// power while they can matter. Debug builds (DICE_DEBUG) also keep track of
+// how long each service stayed subscribed in each state.
+// Shake-to-roll arms on the add-group prompt only, once there is something to
+// roll and the user hasn't switched it off; the rest of the idle screens never
+// pay for the accelerometer.
+static uint8_t prv_state_services(AppState state) {
+  switch (state) {
+    case ADD_GROUP_PROMPT:
+      return (s_ctx.shake_to_roll && model_has_groups(&s_ctx.model)) ? STATE_SERVICE_SHAKE : 0;
+    case ROLLING:
+      return STATE_SERVICE_TAP;
+    case PICK_DIE:
+    case PICK_COUNT:
+    case RESULTS:
+    case HISTORY:
+    case TABLE_FEED:
+      return 0;
+  }
+  return 0;
+}
+
+static bool prv_state_accepts_shake(AppState state) {
+  return (prv_state_services(state) & STATE_SERVICE_SHAKE) != 0;
+}
+
+static void prv_accel_tap_handler(AccelAxisType axis, int32_t direction) {
+  state_handle_tap();
+}
+
+#if defined(DICE_DEBUG)
+static const char *s_service_names[STATE_SERVICE_COUNT] = {"tap", "shake"};
+static uint32_t s_service_ms[APP_STATE_COUNT][STATE_SERVICE_COUNT];
+static int s_services_since_ms;
+
+static void prv_debug_account_services(void) {
+  const int now = sched_now_ms();
+  const int elapsed = now - s_services_since_ms;
+  s_services_since_ms = now;
+  if (elapsed <= 0) {
+    return;
+  }
+  for (int i = 0; i < STATE_SERVICE_COUNT; ++i) {
+    if (s_ctx.active_services & (1 << i)) {
+      s_service_ms[s_ctx.services_state][i] += elapsed;
+    }
+  }
+}
+
+static void prv_debug_log_services(void) {
+  prv_debug_account_services();
+  for (int state = 0; state < APP_STATE_COUNT; ++state) {
+    for (int i = 0; i < STATE_SERVICE_COUNT; ++i) {
+      if (s_service_ms[state][i] > 0) {
+        APP_LOG(APP_LOG_LEVEL_DEBUG, "%s: %s subscribed %lu ms",
+                prv_state_name((AppState)state), s_service_names[i], (unsigned long)s_service_ms[state][i]);
+      }
+    }
+  }
+}
+#endif
+
+static void prv_apply_services(uint8_t wanted) {
+#if defined(DICE_DEBUG)
+  prv_debug_account_services();
+  s_ctx.services_state = s_ctx.current_state;
+#endif
+  const uint8_t changed = wanted ^ s_ctx.active_services;
+  if (changed & STATE_SERVICE_TAP) {
+    if (wanted & STATE_SERVICE_TAP) {
+      accel_tap_service_subscribe(prv_accel_tap_handler);
+    } else {
+      accel_tap_service_unsubscribe();
+    }
+  }
+  if (changed & STATE_SERVICE_SHAKE) {
+    shake_set_enabled((wanted & STATE_SERVICE_SHAKE) != 0);
+  }
+  s_ctx.active_services = wanted;
+}
+
+static void prv_update_sensors(void) {
+  prv_apply_services(s_ctx.initialized ? prv_state_services(s_ctx.current_state) : 0);
+}
+
 static void prv_set_state(AppState new_state) {
   if (s_ctx.current_state == new_state) {
+    prv_update_sensors();
     prv_render();
     return;
   }
@@ -186,29 +378,119 @@ static void prv_set_state(AppState new_state) {
     s_ctx.confirm_clear_prompt = false;
   }
 
+  // Editing the dice by hand means they no longer match the loaded preset.
+  if (new_state == PICK_DIE || new_state == PICK_COUNT) {
+    s_ctx.preset_slot = -1;
+  }
+
   s_ctx.current_state = new_state;
+  s_ctx.state_entered_ms = sched_now_ms();
   APP_LOG(APP_LOG_LEVEL_INFO, "STATE -> %s", prv_state_name(new_state));
+  prv_update_sensors();
   prv_render();
 }
 
-static void prv_anim_preview(int value, void *context) {
-  s_ctx.rolling_value = prv_normalize_roll_value(value);
+static void prv_reset_batch(void) {
+  s_ctx.batch_count = 0;
+  s_ctx.batch_completed = 0;
+  for (int i = 0; i < ROLL_ANIM_MAX_INSTANCES; ++i) {
+    s_ctx.batch_values[i] = -1;
+    s_ctx.batch_handles[i] = ROLL_ANIM_INVALID_HANDLE;
+  }
+}
+
+// The batch slot index travels as the animation callback context.
+static int prv_batch_slot(void *context) {
+  const int slot = (int)(intptr_t)context;
+  return (slot >= 0 && slot < s_ctx.batch_count) ? slot : -1;
+}
+
+static void prv_anim_frame(void *context) {
   prv_render();
 }
 
+// Large pools are answered by the phone; redraw once the odds land.
+static void prv_odds_ready(void *context) {
+  if (s_ctx.current_state == RESULTS) {
+    prv_render();
+  }
+}
+
+// Settings from the phone may retime the active profile or rename a preset.
+static void prv_config_changed(void *context) {
+  if (!preset_get(s_ctx.preset_slot)) {
+    s_ctx.preset_slot = -1;
+  }
+  prv_render();
+}
+
+static void prv_history_ready(void *context) {
+  if (s_ctx.current_state == HISTORY) {
+    prv_render();
+  }
+}
+
+// New rolls land at the top; keep the rows being read in place unless the
+// list is already showing the newest.
+static void prv_table_updated(int added, void *context) {
+  if (s_ctx.current_state != TABLE_FEED) {
+    return;
+  }
+  if (s_ctx.table_top > 0) {
+    s_ctx.table_top += added;
+    if (s_ctx.table_top >= table_feed_count()) {
+      s_ctx.table_top = table_feed_count() - 1;
+    }
+  }
+  prv_render();
+}
+
+static bool prv_table_scroll(int delta) {
+  const int top = s_ctx.table_top + delta;
+  if (top < 0 || top >= table_feed_count()) {
+    return false;
+  }
+  s_ctx.table_top = top;
+  return true;
+}
+
+static void prv_anim_preview(int value, void *context) {
+  const int slot = prv_batch_slot(context);
+  if (slot >= 0) {
+    s_ctx.batch_values[slot] = model_kind_face_value(s_ctx.roll_kind, value);
+  }
+}
+
 static void prv_commit_result(int value) {
   const int sides = model_current_roll_sides(&s_ctx.model);
   model_commit_roll_result(&s_ctx.model, value);
-  s_ctx.rolling_value = value;
 
   const int completed = model_roll_completed_dice(&s_ctx.model);
   const int total = model_roll_total_dice(&s_ctx.model);
   APP_LOG(APP_LOG_LEVEL_INFO, "ROLL d%d → %d (%d/%d)", sides, value, completed, total);
 }
 
+// Results are committed once the whole batch has settled, in die order, so the
+// model's roll cursor never has to deal with out-of-order completions.
 static void prv_anim_complete(int value, void *context) {
-  const int adjusted = prv_normalize_roll_value(value);
-  prv_commit_result(adjusted);
+  const int slot = prv_batch_slot(context);
+  if (slot < 0) {
+    return;
+  }
+  s_ctx.batch_values[slot] = model_kind_face_value(s_ctx.roll_kind, value);
+  s_ctx.batch_handles[slot] = ROLL_ANIM_INVALID_HANDLE;
+  s_ctx.batch_completed++;
+  if (s_ctx.batch_completed < s_ctx.batch_count) {
+    return;
+  }
+
+  const int count = s_ctx.batch_count;
+  int values[ROLL_ANIM_MAX_INSTANCES];
+  memcpy(values, s_ctx.batch_values, sizeof(values));
+  prv_reset_batch();
+  for (int i = 0; i < count; ++i) {
+    prv_commit_result(values[i]);
+  }
   prv_after_result();
 }
 
@@ -224,17 +506,19 @@ static void prv_set_skip_requested(void) {
   s_ctx.skip_requested = true;
   if (s_ctx.result_hold_timer) {
     prv_cancel_result_hold_timer();
-    prv_start_next_die();
+    prv_start_next_batch();
   }
   if (roll_anim_is_running()) {
-    roll_anim_skip();
+    roll_anim_skip_all();
   }
 }
 
-// Core loop that animates one die at a time (or skips instantly when asked).
-// Any changes to roll cadence (holding results longer, etc.) should happen here.
-static void prv_start_next_die(void) {
+// Core loop that animates the next batch of dice from the current group (or
+// skips instantly when asked). Any changes to roll cadence (holding results
+// longer, batch sizes, etc.) should happen here.
+static void prv_start_next_batch(void) {
   prv_cancel_result_hold_timer();
+  prv_reset_batch();
 
   if (!model_has_roll_remaining(&s_ctx.model)) {
     prv_finish_roll();
@@ -242,22 +526,67 @@ static void prv_start_next_die(void) {
   }
 
   prv_prepare_roll_metadata();
-  s_ctx.rolling_value = -1;
 
-  if (s_ctx.skip_requested) {
-    const int result = prv_random_result_value();
-    prv_commit_result(result);
-    prv_start_next_die();
+  // The instant profile takes the same path as a skip: no animation, no holds.
+  RollProfile paced;
+  const RollProfile *profile = prv_active_profile(&paced);
+  if (s_ctx.skip_requested || !profile->animated) {
+    while (model_has_roll_remaining(&s_ctx.model)) {
+      prv_prepare_roll_metadata();
+      prv_commit_result(prv_random_result_value());
+    }
+    prv_finish_roll();
     return;
   }
 
+  const DiceGroup *group = model_get_group(&s_ctx.model, s_ctx.model.roll_group_index);
+  int count = group ? group->count - s_ctx.model.roll_die_index : 1;
+  if (count > ROLL_ANIM_MAX_INSTANCES) {
+    count = ROLL_ANIM_MAX_INSTANCES;
+  }
+  if (count < 1) {
+    count = 1;
+  }
+
   const int range = (s_ctx.roll_range > 0) ? s_ctx.roll_range : 1;
-  roll_anim_start(range);
+  const RollAnimCallbacks callbacks = {
+    .on_preview = prv_anim_preview,
+    .on_complete = prv_anim_complete,
+  };
+  const int start_ms = s_ctx.next_batch_at_ms;
+  s_ctx.batch_count = count;
+  s_ctx.batch_end_ms = start_ms;
+#if defined(DICE_DEBUG)
+  const RollPool *pool = roll_pool_default();
+  const uint32_t hits_before = pool->hits;
+  const uint32_t misses_before = pool->misses;
+  const int setup_started_ms = sched_now_ms();
+#endif
+  prv_prime_pool_for_batch(count, profile);
+  for (int i = 0; i < count; ++i) {
+    RollAnimTimeline timeline;
+    roll_anim_build_timeline(&timeline, range, profile);
+    const int end_ms = start_ms + roll_anim_timeline_duration_ms(&timeline);
+    if (end_ms > s_ctx.batch_end_ms) {
+      s_ctx.batch_end_ms = end_ms;
+    }
+    s_ctx.batch_handles[i] = roll_anim_start_timeline(&timeline, start_ms, &callbacks, (void *)(intptr_t)i);
+  }
+#if defined(DICE_DEBUG)
+  APP_LOG(APP_LOG_LEVEL_DEBUG, "Batch setup: %d dice in %d ms, pool %lu hit / %lu miss",
+          count, sched_now_ms() - setup_started_ms,
+          (unsigned long)(pool->hits - hits_before), (unsigned long)(pool->misses - misses_before));
+#endif
+  prv_schedule_pool_refill();
+  prv_render();
 }
 
 static void prv_finish_roll(void) {
   prv_cancel_result_hold_timer();
+  prv_cancel_pool_refill();
   s_ctx.skip_requested = false;
+  s_ctx.pace_pct = DEFAULT_PACE_PCT;
+  roll_log_record(&s_ctx.model);
   prv_set_state(RESULTS);
 }
 
@@ -269,10 +598,12 @@ static void prv_begin_roll(void) {
   prv_cancel_result_hold_timer();
   model_begin_roll(&s_ctx.model);
   s_ctx.skip_requested = false;
-  s_ctx.rolling_value = -1;
+  s_ctx.next_batch_at_ms = sched_now_ms();
+  prv_reset_batch();
 
   prv_set_state(ROLLING);
-  prv_start_next_die();
+  entropy_reseed_for_roll();
+  prv_start_next_batch();
 }
 
 static void prv_restore_saved_model(void) {
@@ -315,23 +646,89 @@ static void prv_begin_quick_roll(void) {
 
 static void prv_cancel_result_hold_timer(void) {
   if (s_ctx.result_hold_timer) {
-    app_timer_cancel(s_ctx.result_hold_timer);
+    sched_timer_cancel(s_ctx.result_hold_timer);
     s_ctx.result_hold_timer = NULL;
   }
 }
 
 static void prv_result_hold_timer_cb(void *context) {
   s_ctx.result_hold_timer = NULL;
-  prv_start_next_die();
+  prv_start_next_batch();
 }
 
 static void prv_after_result(void) {
-  if (s_ctx.skip_requested) {
-    prv_start_next_die();
+  RollProfile paced;
+  const RollProfile *profile = prv_active_profile(&paced);
+  if (s_ctx.skip_requested || profile->result_hold_ms == 0) {
+    // No hold: the next batch starts where this one ended (or now, if that has
+    // passed), not on this batch's slot, or all its frames would be overdue.
+    const int now_ms = sched_now_ms();
+    s_ctx.next_batch_at_ms = (s_ctx.batch_end_ms > now_ms) ? s_ctx.batch_end_ms : now_ms;
+    prv_start_next_batch();
     return;
   }
   prv_cancel_result_hold_timer();
-  s_ctx.result_hold_timer = app_timer_register(RESULT_HOLD_MS, prv_result_hold_timer_cb, NULL);
+
+  // The hold is measured from when the batch was planned to end, not from
+  // when this callback happened to run.
+  s_ctx.next_batch_at_ms = s_ctx.batch_end_ms + profile->result_hold_ms;
+  s_ctx.result_hold_timer = sched_timer_register_at(s_ctx.next_batch_at_ms, prv_result_hold_timer_cb, NULL);
+  if (!s_ctx.result_hold_timer) {
+    prv_start_next_batch();
+  }
+}
+
+// Shaking does what a long Select press would, at a pace set by its strength.
+// Only the arming state listens, and not until SHAKE_ARM_DELAY_MS after it was
+// entered, so the shake that brought us here can't start a roll.
+static void prv_shake_handler(int energy_per_mille, void *context) {
+  if (!prv_state_accepts_shake(s_ctx.current_state)) {
+    return;
+  }
+  if (sched_now_ms() - s_ctx.state_entered_ms < SHAKE_ARM_DELAY_MS) {
+    APP_LOG(APP_LOG_LEVEL_DEBUG, "Shake ignored while arming");
+    return;
+  }
+  s_ctx.pace_pct = SHAKE_PACE_GENTLE_PCT -
+                   (energy_per_mille * (SHAKE_PACE_GENTLE_PCT - SHAKE_PACE_HARD_PCT)) / 1000;
+  APP_LOG(APP_LOG_LEVEL_INFO, "Shake energy %d -> pace %d%%", energy_per_mille, s_ctx.pace_pct);
+  state_handle_select_long();
+  if (s_ctx.current_state != ROLLING) {
+    s_ctx.pace_pct = DEFAULT_PACE_PCT;
+  }
+}
+
+// Shake-to-roll is on unless the user turned it off; the choice persists.
+static bool prv_load_shake_to_roll(void) {
+  return !persist_exists(PERSIST_KEY_SHAKE_TO_ROLL) || persist_read_bool(PERSIST_KEY_SHAKE_TO_ROLL);
+}
+
+static void prv_toggle_shake_to_roll(void) {
+  s_ctx.shake_to_roll = !s_ctx.shake_to_roll;
+  persist_write_bool(PERSIST_KEY_SHAKE_TO_ROLL, s_ctx.shake_to_roll);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Shake to roll -> %s", s_ctx.shake_to_roll ? "on" : "off");
+  vibes_short_pulse();
+  prv_update_sensors();
+  prv_render();
+}
+
+static void prv_cycle_profile(void) {
+  s_ctx.profile_id = roll_profile_next(s_ctx.profile_id);
+  roll_profile_save(s_ctx.profile_id);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Roll profile -> %s", roll_profile_get(s_ctx.profile_id)->label);
+  prv_render();
+}
+
+// Swaps the configured dice for the next stored preset.
+static void prv_load_next_preset(void) {
+  const int slot = preset_next(s_ctx.preset_slot);
+  if (slot < 0 || !preset_apply(slot, &s_ctx.model)) {
+    return;
+  }
+  model_reset_selection_count(&s_ctx.model);
+  APP_LOG(APP_LOG_LEVEL_INFO, "Preset -> %s", preset_get(slot)->name);
+  s_ctx.preset_slot = slot;
+  prv_set_state(ADD_GROUP_PROMPT);
 }
 
 static bool prv_rewind_last_group(void) {
@@ -352,29 +749,49 @@ void state_init(void) {
   }
 
   memset(&s_ctx, 0, sizeof(s_ctx));
+  entropy_init();
   model_init(&s_ctx.model);
-  s_ctx.rolling_value = -1;
-  RollAnimCallbacks callbacks = {
-    .on_preview = prv_anim_preview,
-    .on_complete = prv_anim_complete,
-  };
-  roll_anim_init(&callbacks, NULL);
+  prv_reset_batch();
+  s_ctx.profile_id = roll_profile_load();
+  s_ctx.preset_slot = -1;
+  preset_init();
+  s_ctx.pace_pct = DEFAULT_PACE_PCT;
+  s_ctx.shake_to_roll = prv_load_shake_to_roll();
+  roll_anim_init(prv_anim_frame, NULL);
+  shake_init(prv_shake_handler, NULL);
+  odds_init(prv_odds_ready, NULL);
+  history_init(prv_history_ready, NULL);
+  config_sync_init(prv_config_changed, NULL);
+  table_feed_init(prv_table_updated, NULL);
   s_ctx.initialized = true;
 
   prv_set_state(PICK_DIE);
+  prv_update_sensors();
 }
 
 void state_deinit(void) {
   prv_cancel_result_hold_timer();
+  prv_cancel_pool_refill();
   roll_anim_deinit();
   s_ctx.initialized = false;
+  prv_update_sensors();
+#if defined(DICE_DEBUG)
+  prv_debug_log_services();
+#endif
+  shake_deinit();
+  odds_deinit();
+  history_deinit();
+  config_sync_deinit();
+  table_feed_deinit();
 }
 
 // ----- Input handlers -------------------------------------------------------
 // Top-level input handlers stay grouped together so you can quickly reason
 // about button mappings. Each switch simply translates the button press to
-// model mutations + state transitions.
+// model mutations + state transitions. Every press also feeds its timing
+// jitter to the entropy pool.
 void state_handle_select(void) {
+  entropy_add_time_jitter();
   switch (s_ctx.current_state) {
     case PICK_DIE:
       model_reset_selection_count(&s_ctx.model);
@@ -405,10 +822,20 @@ void state_handle_select(void) {
       model_reset_selection_count(&s_ctx.model);
       prv_set_state(PICK_DIE);
       break;
+    case HISTORY:
+      history_close();
+      s_ctx.table_top = 0;
+      prv_set_state(TABLE_FEED);
+      break;
+    case TABLE_FEED:
+      history_open();
+      prv_set_state(HISTORY);
+      break;
   }
 }
 
 void state_handle_back(void) {
+  entropy_add_time_jitter();
   switch (s_ctx.current_state) {
     case PICK_DIE:
       if (model_has_groups(&s_ctx.model)) {
@@ -439,10 +866,18 @@ void state_handle_back(void) {
       model_reset_selection_count(&s_ctx.model);
       prv_set_state(PICK_DIE);
       break;
+    case HISTORY:
+      history_close();
+      prv_set_state(PICK_DIE);
+      break;
+    case TABLE_FEED:
+      prv_set_state(PICK_DIE);
+      break;
   }
 }
 
 void state_handle_up(void) {
+  entropy_add_time_jitter();
   switch (s_ctx.current_state) {
     case PICK_DIE:
       model_increment_selected_die(&s_ctx.model, 1);
@@ -457,12 +892,32 @@ void state_handle_up(void) {
         prv_begin_roll();
       }
       break;
+    case HISTORY:
+      if (history_move(-1)) {
+        prv_render();
+      }
+      break;
+    case TABLE_FEED:
+      if (prv_table_scroll(-1)) {
+        prv_render();
+      }
+      break;
     default:
       break;
   }
 }
 
+void state_handle_up_long(void) {
+  entropy_add_time_jitter();
+  if (s_ctx.current_state == PICK_DIE) {
+    prv_cycle_profile();
+  } else if (s_ctx.current_state == PICK_COUNT || s_ctx.current_state == ADD_GROUP_PROMPT) {
+    prv_load_next_preset();
+  }
+}
+
 void state_handle_down(void) {
+  entropy_add_time_jitter();
   switch (s_ctx.current_state) {
     case PICK_DIE:
       model_increment_selected_die(&s_ctx.model, -1);
@@ -482,27 +937,52 @@ void state_handle_down(void) {
     case RESULTS:
       ui_scroll_step(1);
       break;
+    case HISTORY:
+      if (history_move(1)) {
+        prv_render();
+      }
+      break;
+    case TABLE_FEED:
+      if (prv_table_scroll(1)) {
+        prv_render();
+      }
+      break;
     default:
       break;
   }
 }
 
 void state_handle_down_long(void) {
-  if (s_ctx.current_state == ROLLING || s_ctx.current_state == RESULTS) {
+  entropy_add_time_jitter();
+  if (s_ctx.current_state == PICK_DIE) {
+    history_open();
+    prv_set_state(HISTORY);
+  } else if (s_ctx.current_state == ADD_GROUP_PROMPT) {
+    prv_toggle_shake_to_roll();
+  } else if (s_ctx.current_state == ROLLING || s_ctx.current_state == RESULTS) {
     ui_scroll_reset();
   }
 }
 
 void state_handle_tap(void) {
+  entropy_add_time_jitter();
   prv_set_skip_requested();
 }
 
 void state_handle_select_long(void) {
+  entropy_add_time_jitter();
   if (s_ctx.current_state == ROLLING) {
     prv_set_skip_requested();
     return;
   }
 
+  // The browsing screens aren't places to roll from: leaving history must go
+  // through history_close(), or it keeps fetching pages during the roll, and
+  // the table feed would otherwise roll the hidden configuration unasked.
+  if (s_ctx.current_state == HISTORY || s_ctx.current_state == TABLE_FEED) {
+    return;
+  }
+
   if (s_ctx.current_state == PICK_DIE || s_ctx.current_state == PICK_COUNT) {
     prv_begin_quick_roll();
     return;
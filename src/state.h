@@ -7,9 +7,14 @@ typedef enum {
   PICK_COUNT,
   ADD_GROUP_PROMPT,
   ROLLING,
-  RESULTS
+  RESULTS,
+  HISTORY,
+  TABLE_FEED
 } AppState;
 
+// Keep in step with the last AppState value.
+#define APP_STATE_COUNT (TABLE_FEED + 1)
+
 void state_init(void);
 void state_deinit(void);
 
@@ -17,6 +22,7 @@ void state_handle_select(void);
 void state_handle_select_long(void);
 void state_handle_back(void);
 void state_handle_up(void);
+void state_handle_up_long(void);
 void state_handle_down(void);
 void state_handle_down_long(void);
 void state_handle_tap(void);
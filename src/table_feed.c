@@ -0,0 +1,143 @@
+#include "table_feed.h"
+
+#include <string.h>
+
+#include "comm.h"
+#include "frame.h"
+
+// -----------------------------------------------------------------------------
+// TABLE FEED MODULE
+// -----------------------------------------------------------------------------
+// Keeps the latest rolls of everyone at the table. The phone relays them from
+// the table aggregator in batches (one table_feed message carries several
+// framed records, see frame.c), already deduplicated; the watch still skips
+// any (source, seq) it holds, since a batch can be resent after a lost ack.
+// Entries live in a fixed ring buffer, so a busy table overwrites the oldest
+// rolls instead of growing, and the UI reads only the rows it draws.
+//
+// Record: [source:4][seq:2][total:2][name length][name...][group count]
+//         then per group [kind][count]; all integers little-endian.
+//
+// Safe tweaks:
+// - TABLE_FEED_CAPACITY (table_feed.h) trades RAM for scrollback; keep
+//   TABLE_FEED_CAPACITY in src/js/app.js in step.
+
+#define TABLE_FEED_RECORD_HEADER 8
+
+typedef struct {
+  TableFeedEntry entries[TABLE_FEED_CAPACITY];
+  int head;
+  int count;
+  TableFeedHandler on_update;
+  void *update_context;
+} TableFeed;
+
+static TableFeed s_feed;
+
+static uint16_t prv_read_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static bool prv_contains(uint32_t source, uint16_t seq) {
+  for (int i = 0; i < s_feed.count; ++i) {
+    const TableFeedEntry *entry = table_feed_get(i);
+    if (entry->source == source && entry->seq == seq) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Decodes one record straight into the next ring slot; the slot only counts
+// once the record turned out to be complete and new.
+static bool prv_append(const uint8_t *data, uint16_t length) {
+  if (length < TABLE_FEED_RECORD_HEADER + 1) {
+    return false;
+  }
+  const uint32_t source = (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) |
+                          ((uint32_t)data[3] << 24);
+  const uint16_t seq = prv_read_u16(&data[4]);
+  if (prv_contains(source, seq)) {
+    return false;
+  }
+
+  int offset = TABLE_FEED_RECORD_HEADER;
+  const int name_length = data[offset++];
+  if (offset + name_length + 1 > length) {
+    return false;
+  }
+  const int name_offset = offset;
+  offset += name_length;
+  const int groups = data[offset++];
+  if (groups > MAX_DICE_GROUPS || offset + groups * 2 > length) {
+    return false;
+  }
+
+  TableFeedEntry *entry = &s_feed.entries[s_feed.head];
+  memset(entry, 0, sizeof(*entry));
+  entry->source = source;
+  entry->seq = seq;
+  entry->total = prv_read_u16(&data[6]);
+  const int copied = (name_length < TABLE_FEED_NAME_LENGTH - 1) ? name_length : TABLE_FEED_NAME_LENGTH - 1;
+  memcpy(entry->player, &data[name_offset], copied);
+  entry->group_count = (uint8_t)groups;
+  for (int g = 0; g < groups; ++g) {
+    entry->kinds[g] = data[offset++];
+    entry->counts[g] = data[offset++];
+  }
+
+  s_feed.head = (s_feed.head + 1) % TABLE_FEED_CAPACITY;
+  if (s_feed.count < TABLE_FEED_CAPACITY) {
+    s_feed.count++;
+  }
+  return true;
+}
+
+// Records arrive oldest first, so the newest roll ends up at index 0.
+static void prv_feed_received(const uint8_t *body, uint16_t length, void *context) {
+  ProtoTableFeed feed;
+  if (!proto_table_feed_unpack(body, length, &feed)) {
+    return;
+  }
+  int added = 0;
+  uint16_t offset = 0;
+  while (offset < feed.entries_length) {
+    const uint8_t *record;
+    uint16_t record_length;
+    const uint16_t consumed = frame_decode(&feed.entries[offset], feed.entries_length - offset, &record,
+                                           &record_length);
+    if (consumed == 0) {
+      APP_LOG(APP_LOG_LEVEL_WARNING, "Table feed: corrupt frame at %u", offset);
+      break;
+    }
+    if (prv_append(record, record_length)) {
+      ++added;
+    }
+    offset += consumed;
+  }
+  if (added > 0 && s_feed.on_update) {
+    s_feed.on_update(added, s_feed.update_context);
+  }
+}
+
+void table_feed_init(TableFeedHandler on_update, void *context) {
+  memset(&s_feed, 0, sizeof(s_feed));
+  s_feed.on_update = on_update;
+  s_feed.update_context = context;
+  comm_subscribe(PROTO_MSG_TABLE_FEED, prv_feed_received, NULL);
+}
+
+void table_feed_deinit(void) {
+  s_feed.on_update = NULL;
+}
+
+int table_feed_count(void) {
+  return s_feed.count;
+}
+
+const TableFeedEntry *table_feed_get(int index) {
+  if (index < 0 || index >= s_feed.count) {
+    return NULL;
+  }
+  return &s_feed.entries[(s_feed.head - 1 - index + TABLE_FEED_CAPACITY) % TABLE_FEED_CAPACITY];
+}
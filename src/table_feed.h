@@ -0,0 +1,32 @@
+#pragma once
+
+#include <pebble.h>
+
+#include "dicecore/model.h"
+
+#define TABLE_FEED_CAPACITY 16
+#define TABLE_FEED_NAME_LENGTH 12
+
+typedef void (*TableFeedHandler)(int added, void *context);
+
+// One roll made at the table, by this or another player's watch. `source`
+// identifies the rolling watch (and app launch) as the phone reports it.
+typedef struct {
+  uint32_t source;
+  uint16_t seq;
+  uint16_t total;
+  char player[TABLE_FEED_NAME_LENGTH];
+  uint8_t group_count;
+  uint8_t kinds[MAX_DICE_GROUPS];
+  uint8_t counts[MAX_DICE_GROUPS];
+} TableFeedEntry;
+
+// `on_update` runs after a feed message added at least one entry, with how
+// many it added.
+void table_feed_init(TableFeedHandler on_update, void *context);
+void table_feed_deinit(void);
+
+// Entries held, at most TABLE_FEED_CAPACITY.
+int table_feed_count(void);
+// Entry `index` places back from the newest (0), or NULL past the end.
+const TableFeedEntry *table_feed_get(int index);
@@ -4,6 +4,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "table_feed.h"
+
 // -----------------------------------------------------------------------------
 // UI MODULE
 // -----------------------------------------------------------------------------
@@ -35,6 +37,8 @@
 #define SLOTS_LAYER_TOP (MAIN_LAYER_TOP + 48)
 #define SLOTS_TOP_WIDE SLOTS_LAYER_TOP
 #define SLOTS_TOP_COMPACT (SUMMARY_BOTTOM + 4)
+#define TABLE_ROW_HEIGHT 36
+#define TABLE_LINE_HEIGHT 17
 
 #ifndef CLAMP
 #define CLAMP(value, min_value, max_value) ((value) < (min_value) ? (min_value) : ((value) > (max_value) ? (max_value) : (value)))
@@ -333,9 +337,11 @@ static void prv_draw_result_slots(GContext *ctx, const DiceGroup *group, int g_i
     const bool is_done = (s_active_view.state == RESULTS) ||
                          (g_index < s_active_model->roll_group_index) ||
                          (g_index == s_active_model->roll_group_index && d < s_active_model->roll_die_index);
+    const int batch_slot = d - s_active_model->roll_die_index;
     const bool is_current = (s_active_view.state == ROLLING) &&
                             model_has_roll_remaining(s_active_model) &&
-                            (g_index == s_active_model->roll_group_index && d == s_active_model->roll_die_index);
+                            g_index == s_active_model->roll_group_index &&
+                            batch_slot >= 0 && batch_slot < s_active_view.rolling_count;
 
     GColor fill = prv_color_pending();
     GColor text_color = GColorWhite;
@@ -350,8 +356,9 @@ static void prv_draw_result_slots(GContext *ctx, const DiceGroup *group, int g_i
     } else if (is_current) {
       fill = prv_color_pending();
       text_color = prv_color_anim_text(s_active_view.anim_progress_per_mille);
-      if (s_active_view.rolling_value >= 0) {
-        prv_format_slot_value(group, s_active_view.rolling_value, value, sizeof(value));
+      const int rolling_value = s_active_view.rolling_values[batch_slot];
+      if (rolling_value >= 0) {
+        prv_format_slot_value(group, rolling_value, value, sizeof(value));
       }
     }
 
@@ -363,6 +370,41 @@ static void prv_draw_result_slots(GContext *ctx, const DiceGroup *group, int g_i
   *y_ref = y;
 }
 
+// "3d6 + 1d20" for a summarized roll.
+static int prv_format_dice_list(const uint8_t *kinds, const uint8_t *counts, int group_count, char *buffer,
+                                size_t size) {
+  int length = 0;
+  buffer[0] = '\0';
+  for (int g = 0; g < group_count && length < (int)size; ++g) {
+    length += snprintf(buffer + length, size - length, "%s%d%s", g == 0 ? "" : " + ", counts[g],
+                       model_kind_label((DiceKind)kinds[g]));
+  }
+  return length;
+}
+
+// Table rows are drawn straight from the feed's ring buffer, and only the ones
+// that fit below `table_top`, so nothing per row is kept between redraws.
+static void prv_draw_table_rows(GContext *ctx, int width, int height) {
+  int y = SLOT_SPACING;
+  for (int i = s_active_view.table_top; i < s_active_view.table_count && y < height; ++i) {
+    const TableFeedEntry *entry = table_feed_get(i);
+    if (!entry) {
+      break;
+    }
+    char line[48];
+    snprintf(line, sizeof(line), "%s: %u", entry->player[0] ? entry->player : "?", entry->total);
+    graphics_context_set_text_color(ctx, GColorBlack);
+    graphics_draw_text(ctx, line, fonts_get_system_font(FONT_KEY_GOTHIC_14_BOLD),
+                       GRect(SLOT_SPACING, y, width - SLOT_SPACING * 2, TABLE_LINE_HEIGHT),
+                       GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft, NULL);
+    prv_format_dice_list(entry->kinds, entry->counts, entry->group_count, line, sizeof(line));
+    graphics_draw_text(ctx, line, fonts_get_system_font(FONT_KEY_GOTHIC_14),
+                       GRect(SLOT_SPACING, y + TABLE_LINE_HEIGHT, width - SLOT_SPACING * 2, TABLE_LINE_HEIGHT),
+                       GTextOverflowModeTrailingEllipsis, GTextAlignmentLeft, NULL);
+    y += TABLE_ROW_HEIGHT;
+  }
+}
+
 static void prv_slots_update_proc(Layer *layer, GContext *ctx) {
   graphics_context_set_fill_color(ctx, GColorWhite);
   graphics_fill_rect(ctx, layer_get_bounds(layer), 0, GCornerNone);
@@ -372,6 +414,10 @@ static void prv_slots_update_proc(Layer *layer, GContext *ctx) {
   }
 
   const int width = layer_get_bounds(layer).size.w;
+  if (s_active_view.state == TABLE_FEED) {
+    prv_draw_table_rows(ctx, width, layer_get_bounds(layer).size.h);
+    return;
+  }
   int y = SLOT_SPACING - s_scroll_offset;
 
   if (s_active_view.state == ADD_GROUP_PROMPT) {
@@ -407,8 +453,12 @@ static void prv_slots_update_proc(Layer *layer, GContext *ctx) {
   }
 }
 
-static void prv_render_pick_die(const DiceModel *model) {
-  snprintf(s_title_buffer, sizeof(s_title_buffer), "Pick Die");
+static void prv_render_pick_die(const DiceModel *model, const UiRenderData *data) {
+  if (data->profile_label) {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Pick Die (%s)", data->profile_label);
+  } else {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Pick Die");
+  }
   snprintf(s_main_buffer, sizeof(s_main_buffer), "%s", model_get_selected_label(model));
 }
 
@@ -420,6 +470,8 @@ static void prv_render_pick_count(const DiceModel *model) {
 static void prv_render_add_prompt(const DiceModel *model, const UiRenderData *data) {
   if (data->confirm_clear_prompt) {
     snprintf(s_title_buffer, sizeof(s_title_buffer), "Clear dice?");
+  } else if (data->preset_name) {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "%s", data->preset_name);
   } else {
     s_title_buffer[0] = '\0';
   }
@@ -432,7 +484,50 @@ static void prv_render_rolling(const DiceModel *model, const UiRenderData *data)
 }
 
 static void prv_render_results(const DiceModel *model, const UiRenderData *data) {
-  snprintf(s_title_buffer, sizeof(s_title_buffer), "Results");
+  if (data->total_percentile >= 0) {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Results (p%d)", data->total_percentile);
+  } else {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Results");
+  }
+  s_main_buffer[0] = '\0';
+}
+
+// One past roll per screen: its dice on the summary line, the total large.
+static void prv_render_history(const UiRenderData *data) {
+  if (data->history_count > 0) {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "History %d/%d", data->history_index + 1, data->history_count);
+  } else {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "History");
+  }
+
+  const HistoryEntry *entry = data->history_entry;
+  if (data->history_count == 0) {
+    s_summary_buffer[0] = '\0';
+    snprintf(s_main_buffer, sizeof(s_main_buffer), "No rolls");
+    return;
+  }
+  if (!entry) {
+    s_summary_buffer[0] = '\0';
+    snprintf(s_main_buffer, sizeof(s_main_buffer), "...");
+    return;
+  }
+
+  const int length = snprintf(s_summary_buffer, sizeof(s_summary_buffer), "#%u ", entry->seq);
+  if (length < (int)sizeof(s_summary_buffer)) {
+    prv_format_dice_list(entry->kinds, entry->counts, entry->group_count, s_summary_buffer + length,
+                         sizeof(s_summary_buffer) - length);
+  }
+  snprintf(s_main_buffer, sizeof(s_main_buffer), "%u", entry->total);
+}
+
+static void prv_render_table_feed(const UiRenderData *data) {
+  if (data->table_count > 0) {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Table %d/%d", data->table_top + 1, data->table_count);
+    s_summary_buffer[0] = '\0';
+  } else {
+    snprintf(s_title_buffer, sizeof(s_title_buffer), "Table");
+    snprintf(s_summary_buffer, sizeof(s_summary_buffer), "No table rolls yet");
+  }
   s_main_buffer[0] = '\0';
 }
 
@@ -570,7 +665,6 @@ void ui_render(const UiRenderData *data, const DiceModel *model) {
   s_active_model = model;
 
   prv_build_summary_text(model, s_summary_buffer, sizeof(s_summary_buffer));
-  text_layer_set_text(s_summary_layer, s_summary_buffer);
 
   bool show_main_text = true;
   bool show_picker_icon = false;
@@ -579,7 +673,7 @@ void ui_render(const UiRenderData *data, const DiceModel *model) {
   switch (data->state) {
     case PICK_DIE:
       prv_toggle_slots_visibility(false);
-      prv_render_pick_die(model);
+      prv_render_pick_die(model, data);
       show_main_text = true;
       show_picker_icon = true;
       break;
@@ -606,6 +700,17 @@ void ui_render(const UiRenderData *data, const DiceModel *model) {
       show_main_text = false;
       slots_top = SLOTS_TOP_COMPACT;
       break;
+    case HISTORY:
+      prv_toggle_slots_visibility(false);
+      prv_render_history(data);
+      show_main_text = true;
+      break;
+    case TABLE_FEED:
+      prv_toggle_slots_visibility(true);
+      prv_render_table_feed(data);
+      show_main_text = false;
+      slots_top = SLOTS_TOP_COMPACT;
+      break;
   }
 
   const DiceKind selected_kind = (DiceKind)model_get_selected_die_index(model);
@@ -613,6 +718,7 @@ void ui_render(const UiRenderData *data, const DiceModel *model) {
   layer_set_hidden(text_layer_get_layer(s_main_layer), !show_main_text);
 
   text_layer_set_text(s_title_layer, s_title_buffer);
+  text_layer_set_text(s_summary_layer, s_summary_buffer);
   text_layer_set_text(s_main_layer, s_main_buffer);
   prv_set_slots_frame(slots_top);
 
@@ -2,7 +2,9 @@
 
 #include <pebble.h>
 
-#include "model.h"
+#include "history.h"
+#include "dicecore/model.h"
+#include "roll_anim.h"
 #include "state.h"
 
 #define UI_HINT_TEXT_LENGTH 12
@@ -11,9 +13,18 @@
 // hints/flags here means you only need to touch state.c when prototyping flows.
 typedef struct {
   AppState state;
-  int rolling_value;
+  int rolling_values[ROLL_ANIM_MAX_INSTANCES];
+  int rolling_count;
   int anim_progress_per_mille;
   bool confirm_clear_prompt;
+  const char *profile_label;
+  const char *preset_name;
+  int total_percentile;
+  const HistoryEntry *history_entry;
+  int history_index;
+  int history_count;
+  int table_top;
+  int table_count;
   char hint_top[UI_HINT_TEXT_LENGTH];
   char hint_middle[UI_HINT_TEXT_LENGTH];
   char hint_bottom[UI_HINT_TEXT_LENGTH];
@@ -0,0 +1,484 @@
+// -----------------------------------------------------------------------------
+// DICESIM TOOL
+// -----------------------------------------------------------------------------
+// Bulk dice roller for Linux hosts: rolls a dice configuration TRIALS times
+// across all cores with the watch's own model and generator (src/dicecore) and
+// prints the distribution of the totals.
+//
+//   cc -O2 -iquote src -iquote tools -o dicesim tools/dicesim.c tools/rng_check.c tools/rng_lanes.c
+//      src/dicecore/*.c -lpthread -lm
+//   ./dicesim [-t THREADS] [-s SEED] [-i ISA] [-H] DICE TRIALS
+//   ./dicesim -t 16 3d6+1d20 2G
+//   ./dicesim -c [-s SEED] [DRAWS]
+//   ./dicesim -x [-t THREADS] [-s SEED] [CONFIGS [TRIALS]]
+//
+// DICE is groups joined by '+', each COUNT then a die label from model.c (d4,
+// d6, ..., d100, d%); TRIALS takes a k/M/G suffix. Every thread owns its
+// generator and histogram: all threads seed alike and thread i jumps 2^64 draws
+// i * RNG_LANES times (rng_jump), so streams never overlap and nothing is
+// shared until the histograms are merged after the join. Each thread rolls
+// RNG_LANES trials at once on the vector generator (tools/rng_lanes.c); -i
+// picks scalar, sse2 or avx2, by default the widest the CPU has. A run is
+// reproducible for a given seed and thread count, whatever the ISA. Build with
+// -iquote, not -I: src/sched.h would shadow the libc <sched.h> that
+// <pthread.h> includes.
+//
+// -c checks the generators instead (tools/rng_check.c): DRAWS values per die
+// kind through the app's roll pool and the lanes generator, exiting 1 if any
+// kind looks biased. -x cross-validates the exact odds math
+// (dicecore/distribution.c) against parallel Monte Carlo runs of CONFIGS
+// random configurations, exiting 1 if any CDF strays past its bound.
+//
+// Safe tweaks:
+// - Add percentiles to s_percentiles.
+// - THREADS_MAX only bounds the worker array; the default is one per core.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "dicecore/distribution.h"
+#include "dicecore/model.h"
+#include "dicecore/rng.h"
+#include "rng_check.h"
+#include "rng_lanes.h"
+
+#define THREADS_MAX 256
+// Default draws per die kind and path for -c.
+#define CHECK_DRAWS_DEFAULT 32000000ull
+// Defaults for -x, and the chance a correct configuration still fails it.
+#define CROSS_CONFIGS_DEFAULT 16
+#define CROSS_TRIALS_DEFAULT 4000000ull
+#define CROSS_ALPHA 1e-6
+
+static const double s_percentiles[] = {0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.99};
+
+// One group of the configuration. Every kind's faces step evenly from the
+// first (d100: 0, 10, ..., 90), so a group adds `step` times the sum of its
+// 0-based draws on top of the minimum total.
+typedef struct {
+  int count;
+  uint32_t sides;
+  int step;
+} SimGroup;
+
+typedef struct {
+  SimGroup groups[MAX_DICE_GROUPS];
+  int group_count;
+  int min_total;
+  int max_total;
+} SimConfig;
+
+// Allocated one per thread so no two workers write the same cache line.
+typedef struct {
+  pthread_t thread;
+  const SimConfig *config;
+  RngLanesIsa isa;
+  RngState rng;
+  uint64_t trials;
+  uint64_t *histogram;
+} SimWorker;
+
+static double prv_now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int prv_usage(const char *name) {
+  fprintf(stderr, "usage: %s [-t THREADS] [-s SEED] [-i scalar|sse2|avx2] [-H] DICE TRIALS\n"
+                  "       %s -c [-s SEED] [DRAWS]\n"
+                  "       %s -x [-t THREADS] [-s SEED] [-i ISA] [CONFIGS [TRIALS]]\n"
+                  "  e.g. %s -t 8 3d6+1d20 100M\n", name, name, name, name);
+  return 2;
+}
+
+static bool prv_kind_from_label(const char *label, size_t length, DiceKind *kind) {
+  for (int k = 0; k < DICE_KIND_COUNT; ++k) {
+    const char *candidate = model_kind_label((DiceKind)k);
+    if (strlen(candidate) == length && strncmp(candidate, label, length) == 0) {
+      *kind = (DiceKind)k;
+      return true;
+    }
+  }
+  return false;
+}
+
+// "3d6+1d20": validated through model_add_group so the limits match the watch.
+static bool prv_parse_dice(const char *text, DiceModel *model) {
+  model_init(model);
+  const char *cursor = text;
+  while (*cursor) {
+    char *end = NULL;
+    long count = strtol(cursor, &end, 10);
+    if (end == cursor) {
+      count = 1;
+    }
+    const char *label = end;
+    const char *next = strchr(label, '+');
+    size_t length = next ? (size_t)(next - label) : strlen(label);
+    DiceKind kind;
+    if (!prv_kind_from_label(label, length, &kind) || !model_add_group(model, kind, (int)count)) {
+      fprintf(stderr, "bad dice group '%.*s' (COUNT 1-%d, at most %d groups)\n",
+              (int)(length + (label - cursor)), cursor, MAX_DICE_PER_GROUP, MAX_DICE_GROUPS);
+      return false;
+    }
+    cursor = next ? next + 1 : label + length;
+  }
+  return model_group_count(model) > 0;
+}
+
+// "3d6+12d%", the inverse of prv_parse_dice().
+static void prv_format_dice(const DiceModel *model, char *out, size_t size) {
+  size_t used = 0;
+  out[0] = '\0';
+  for (int g = 0; g < model_group_count(model) && used < size; ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    used += (size_t)snprintf(out + used, size - used, "%s%d%s", g ? "+" : "", group->count,
+                             model_kind_label((DiceKind)group->die_def_index));
+  }
+}
+
+static bool prv_config_from_model(const DiceModel *model, SimConfig *config) {
+  memset(config, 0, sizeof(*config));
+  config->group_count = model_group_count(model);
+  for (int g = 0; g < config->group_count; ++g) {
+    const DiceGroup *group = model_get_group(model, g);
+    const DiceKind kind = (DiceKind)group->die_def_index;
+    SimGroup *sim = &config->groups[g];
+    sim->count = group->count;
+    sim->sides = (uint32_t)model_kind_roll_sides(kind);
+    const int first = model_kind_face_value(kind, 1);
+    sim->step = (sim->sides > 1) ? model_kind_face_value(kind, 2) - first : 0;
+    for (uint32_t raw = 1; raw <= sim->sides; ++raw) {
+      if (model_kind_face_value(kind, (int)raw) != first + sim->step * (int)(raw - 1)) {
+        fprintf(stderr, "%s faces are not evenly spaced\n", model_kind_label(kind));
+        return false;
+      }
+    }
+    config->min_total += sim->count * first;
+    config->max_total += sim->count * (first + sim->step * (int)(sim->sides - 1));
+  }
+  return config->group_count > 0;
+}
+
+// RNG_LANES_ISA_COUNT for an unknown name.
+static RngLanesIsa prv_parse_isa(const char *name) {
+  for (int isa = 0; isa < RNG_LANES_ISA_COUNT; ++isa) {
+    if (strcmp(name, rng_lanes_isa_name((RngLanesIsa)isa)) == 0) {
+      return (RngLanesIsa)isa;
+    }
+  }
+  return RNG_LANES_ISA_COUNT;
+}
+
+// "100M" -> 100000000. 0 on anything unparsable.
+static uint64_t prv_parse_count(const char *text) {
+  char *end = NULL;
+  uint64_t value = strtoull(text, &end, 10);
+  if (end == text) {
+    return 0;
+  }
+  switch (*end) {
+    case '\0': return value;
+    case 'k': case 'K': value *= 1000ull; break;
+    case 'm': case 'M': value *= 1000000ull; break;
+    case 'g': case 'G': value *= 1000000000ull; break;
+    default: return 0;
+  }
+  return end[1] == '\0' ? value : 0;
+}
+
+static void *prv_worker_main(void *arg) {
+  SimWorker *worker = arg;
+  const SimConfig *config = worker->config;
+  uint64_t *histogram = worker->histogram;
+  RngLanes lanes;
+  rng_lanes_seed(&lanes, &worker->rng);
+  for (uint64_t t = 0; t < worker->trials; t += RNG_LANES) {
+    // Offsets from the minimum total, one trial per lane.
+    uint32_t offsets[RNG_LANES] = {0};
+    for (int g = 0; g < config->group_count; ++g) {
+      const SimGroup *group = &config->groups[g];
+      uint32_t sums[RNG_LANES] = {0};
+      rng_lanes_sum(&lanes, worker->isa, group->sides, group->count, sums);
+      for (int i = 0; i < RNG_LANES; ++i) {
+        offsets[i] += (uint32_t)group->step * sums[i];
+      }
+    }
+    const uint64_t left = worker->trials - t;
+    const int used = left < RNG_LANES ? (int)left : RNG_LANES;
+    for (int i = 0; i < used; ++i) {
+      histogram[offsets[i]]++;
+    }
+  }
+  return NULL;
+}
+
+// Spreads the 32-bit user seed over the whole 128-bit state (splitmix32).
+static void prv_expand_seed(uint32_t seed, uint32_t out[4]) {
+  for (int i = 0; i < 4; ++i) {
+    uint32_t z = (seed += 0x9E3779B9u);
+    z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+    z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+    out[i] = z ^ (z >> 16);
+  }
+}
+
+// Rolls `trials` trials of `config` on `threads` threads into `merged`
+// (max_total - min_total + 1 zeroed bins). Thread i's lanes start i *
+// RNG_LANES * 2^64 draws past `base`, which is left past the last thread so a
+// following run gets fresh streams.
+static bool prv_simulate(const SimConfig *config, RngState *base, long threads, RngLanesIsa isa, uint64_t trials,
+                         uint64_t *merged) {
+  const int bins = config->max_total - config->min_total + 1;
+  SimWorker *workers[THREADS_MAX];
+  long started = 0;
+  bool ok = true;
+  for (; started < threads; ++started) {
+    SimWorker *worker = calloc(1, sizeof(*worker));
+    uint64_t *histogram = calloc((size_t)bins, sizeof(*histogram));
+    if (!worker || !histogram) {
+      fprintf(stderr, "out of memory\n");
+      free(worker);
+      free(histogram);
+      ok = false;
+      break;
+    }
+    worker->config = config;
+    worker->isa = isa;
+    worker->rng = *base;
+    worker->trials = trials / threads + ((uint64_t)started < trials % threads ? 1 : 0);
+    worker->histogram = histogram;
+    workers[started] = worker;
+    for (int lane = 0; lane < RNG_LANES; ++lane) {
+      rng_jump(base);
+    }
+    if (pthread_create(&worker->thread, NULL, prv_worker_main, worker) != 0) {
+      fprintf(stderr, "pthread_create failed\n");
+      free(histogram);
+      free(worker);
+      ok = false;
+      break;
+    }
+  }
+
+  for (long i = 0; i < started; ++i) {
+    pthread_join(workers[i]->thread, NULL);
+    for (int b = 0; b < bins; ++b) {
+      merged[b] += workers[i]->histogram[b];
+    }
+    free(workers[i]->histogram);
+    free(workers[i]);
+  }
+  return ok;
+}
+
+// Random configurations within MAX_DICE_GROUPS/MAX_DICE_PER_GROUP: the exact
+// distribution from dicecore/distribution.c against a Monte Carlo run of the
+// same configuration. Each die's pass truncates every weight by under one
+// unit, so the mass lost is below the sum of the pass lengths; a run losing
+// more fails outright. Renormalising moves the CDF by at most that fraction,
+// so the largest CDF gap may be it plus the DKW bound for CROSS_ALPHA.
+// Returns how many configurations failed.
+static int prv_cross_validate(int configs, uint64_t trials, long threads, RngLanesIsa isa, const uint32_t seed[4]) {
+  RngState base;
+  RngState picker;
+  rng_seed(&base, seed);
+  const uint32_t picker_seed[4] = {seed[0] ^ 0x5DEECE66u, seed[1], seed[2], seed[3]};
+  rng_seed(&picker, picker_seed);
+  const double dkw = sqrt(log(2 / CROSS_ALPHA) / (2 * (double)trials));
+  int failures = 0;
+
+  printf("%d configuration(s) x %" PRIu64 " trials on %ld thread(s), %s; DKW bound %.5f\n", configs, trials, threads,
+         rng_lanes_isa_name(isa), dkw);
+  printf("%-56s %6s %9s %9s %9s\n", "dice", "span", "max gap", "fixed pt", "bound");
+  for (int c = 0; c < configs; ++c) {
+    DiceModel model;
+    model_init(&model);
+    const int groups = 1 + (int)rng_bounded(&picker, MAX_DICE_GROUPS);
+    for (int g = 0; g < groups; ++g) {
+      model_add_group(&model, (DiceKind)rng_bounded(&picker, DICE_KIND_COUNT),
+                      1 + (int)rng_bounded(&picker, MAX_DICE_PER_GROUP));
+    }
+    char label[MAX_DICE_GROUPS * 8];
+    prv_format_dice(&model, label, sizeof(label));
+
+    SimConfig config;
+    int min_total, max_total;
+    distribution_range(&model, &min_total, &max_total);
+    if (!prv_config_from_model(&model, &config) || min_total != config.min_total ||
+        max_total != config.max_total) {
+      printf("%-56s range %d..%d, simulated %d..%d  MISMATCH\n", label, min_total, max_total, config.min_total,
+             config.max_total);
+      failures++;
+      continue;
+    }
+    const int bins = max_total - min_total + 1;
+    uint32_t *dist = malloc((size_t)bins * sizeof(*dist));
+    uint64_t *histogram = calloc((size_t)bins, sizeof(*histogram));
+    if (!dist || !histogram || !prv_simulate(&config, &base, threads, isa, trials, histogram)) {
+      free(dist);
+      free(histogram);
+      return failures + configs - c;
+    }
+    distribution_compute(&model, dist);
+
+    uint64_t mass = 0;
+    for (int b = 0; b < bins; ++b) {
+      mass += dist[b];
+    }
+    uint64_t length = 1;
+    uint64_t lost_max = 0;
+    for (int g = 0; g < config.group_count; ++g) {
+      for (int d = 0; d < config.groups[g].count; ++d) {
+        length += (uint64_t)config.groups[g].step * (config.groups[g].sides - 1);
+        lost_max += length;
+      }
+    }
+    const double truncated = (double)lost_max / (DISTRIBUTION_FIXED_ONE - lost_max);
+    uint64_t exact = 0;
+    uint64_t seen = 0;
+    double gap = 0;
+    for (int b = 0; b < bins; ++b) {
+      exact += dist[b];
+      seen += histogram[b];
+      gap = fmax(gap, fabs((double)exact / mass - (double)seen / trials));
+    }
+    const bool ok = DISTRIBUTION_FIXED_ONE - mass <= lost_max && gap <= dkw + truncated;
+    printf("%-56s %6d %9.5f %9.5f %9.5f  %s\n", label, bins - 1, gap, truncated, dkw + truncated,
+           ok ? "ok" : "MISMATCH");
+    failures += ok ? 0 : 1;
+    free(dist);
+    free(histogram);
+  }
+  return failures;
+}
+
+static void prv_print_summary(const SimConfig *config, const uint64_t *histogram, uint64_t trials) {
+  const int bins = config->max_total - config->min_total + 1;
+  double sum = 0;
+  for (int b = 0; b < bins; ++b) {
+    sum += (double)histogram[b] * (config->min_total + b);
+  }
+  const double mean = sum / trials;
+  double variance = 0;
+  int lowest = config->max_total;
+  int highest = config->min_total;
+  for (int b = 0; b < bins; ++b) {
+    if (histogram[b]) {
+      const double delta = config->min_total + b - mean;
+      variance += delta * delta * histogram[b];
+      lowest = (config->min_total + b < lowest) ? config->min_total + b : lowest;
+      highest = config->min_total + b;
+    }
+  }
+  printf("mean %.4f  stddev %.4f  min %d  max %d  (range %d..%d)\n", mean, sqrt(variance / trials), lowest,
+         highest, config->min_total, config->max_total);
+
+  const size_t count = sizeof(s_percentiles) / sizeof(s_percentiles[0]);
+  uint64_t seen = 0;
+  size_t next = 0;
+  for (int b = 0; b < bins && next < count; ++b) {
+    seen += histogram[b];
+    while (next < count && seen >= (uint64_t)ceil(s_percentiles[next] * trials)) {
+      printf("%sp%g %d", next ? "  " : "", s_percentiles[next] * 100, config->min_total + b);
+      next++;
+    }
+  }
+  printf("\n");
+}
+
+int main(int argc, char **argv) {
+  long threads = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t seed = (uint32_t)time(NULL) ^ ((uint32_t)getpid() << 16);
+  RngLanesIsa isa = rng_lanes_best_isa();
+  bool print_histogram = false;
+  bool check_rng = false;
+  bool cross_validate = false;
+  int opt;
+  while ((opt = getopt(argc, argv, "t:s:i:Hcx")) != -1) {
+    switch (opt) {
+      case 't': threads = atol(optarg); break;
+      case 's': seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'i':
+        isa = prv_parse_isa(optarg);
+        if (!rng_lanes_isa_supported(isa)) {
+          fprintf(stderr, "ISA '%s' not available here\n", optarg);
+          return 2;
+        }
+        break;
+      case 'H': print_histogram = true; break;
+      case 'c': check_rng = true; break;
+      case 'x': cross_validate = true; break;
+      default: return prv_usage(argv[0]);
+    }
+  }
+  uint32_t seed_words[4];
+  prv_expand_seed(seed, seed_words);
+  if (check_rng) {
+    const uint64_t draws = (optind < argc) ? prv_parse_count(argv[optind]) : CHECK_DRAWS_DEFAULT;
+    if (argc - optind > 1 || draws < 2) {
+      return prv_usage(argv[0]);
+    }
+    printf("seed %" PRIu32 "\n", seed);
+    return rng_check_run(draws, seed_words) == 0 ? 0 : 1;
+  }
+  if (threads < 1 || threads > THREADS_MAX) {
+    return prv_usage(argv[0]);
+  }
+  if (cross_validate) {
+    const int configs = (optind < argc) ? atoi(argv[optind]) : CROSS_CONFIGS_DEFAULT;
+    const uint64_t trials = (optind + 1 < argc) ? prv_parse_count(argv[optind + 1]) : CROSS_TRIALS_DEFAULT;
+    if (argc - optind > 2 || configs < 1 || trials == 0) {
+      return prv_usage(argv[0]);
+    }
+    printf("seed %" PRIu32 "\n", seed);
+    return prv_cross_validate(configs, trials, threads, isa, seed_words) == 0 ? 0 : 1;
+  }
+  DiceModel model;
+  SimConfig config;
+  if (argc - optind != 2 || !prv_parse_dice(argv[optind], &model) || !prv_config_from_model(&model, &config)) {
+    return prv_usage(argv[0]);
+  }
+  const uint64_t trials = prv_parse_count(argv[optind + 1]);
+  if (trials == 0) {
+    return prv_usage(argv[0]);
+  }
+  if ((uint64_t)threads > trials) {
+    threads = (long)trials;
+  }
+
+  const int bins = config.max_total - config.min_total + 1;
+  RngState base;
+  rng_seed(&base, seed_words);
+  uint64_t *merged = calloc((size_t)bins, sizeof(*merged));
+  const double started = prv_now_s();
+  if (!merged || !prv_simulate(&config, &base, threads, isa, trials, merged)) {
+    return 1;
+  }
+  const double elapsed = prv_now_s() - started;
+
+  uint64_t dice_per_trial = 0;
+  for (int g = 0; g < config.group_count; ++g) {
+    dice_per_trial += (uint64_t)config.groups[g].count;
+  }
+  printf("%s x %" PRIu64 " trials (%" PRIu64 " dice) on %ld thread(s), %s, seed %" PRIu32 "\n", argv[optind],
+         trials, trials * dice_per_trial, threads, rng_lanes_isa_name(isa), seed);
+  printf("%.3f s, %.1f M dice/s\n", elapsed, trials * (double)dice_per_trial / elapsed / 1e6);
+  prv_print_summary(&config, merged, trials);
+  if (print_histogram) {
+    for (int b = 0; b < bins; ++b) {
+      printf("%d\t%" PRIu64 "\t%.6f\n", config.min_total + b, merged[b], (double)merged[b] / trials);
+    }
+  }
+  free(merged);
+  return 0;
+}
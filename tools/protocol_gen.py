@@ -0,0 +1,313 @@
+#!/usr/bin/env python
+"""Generates the watch and phone codecs from protocol/dice_protocol.json.
+
+    python tools/protocol_gen.py [--check]
+
+Writes src/protocol.h, src/protocol.c and src/js/protocol.js, touching a file
+only when its contents change so incremental builds stay incremental. With
+--check nothing is written and the exit status says whether the generated
+files are stale. The generated files are checked in; every waf build runs
+the check and fails when they are stale.
+"""
+
+import json
+import os
+import sys
+
+ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), '..'))
+DEFINITION = os.path.join(ROOT, 'protocol', 'dice_protocol.json')
+OUTPUTS = {
+    'c_header': os.path.join(ROOT, 'src', 'protocol.h'),
+    'c_source': os.path.join(ROOT, 'src', 'protocol.c'),
+    'js': os.path.join(ROOT, 'src', 'js', 'protocol.js'),
+}
+
+TYPE_WIDTHS = {'u8': 1, 'u16': 2, 'u32': 4}
+C_TYPES = {'u8': 'uint8_t', 'u16': 'uint16_t', 'u32': 'uint32_t'}
+
+BANNER = 'GENERATED by tools/protocol_gen.py from protocol/dice_protocol.json -- do not edit.'
+
+
+def camel(name, upper_first):
+    parts = name.split('_')
+    head = parts[0].capitalize() if upper_first else parts[0]
+    return head + ''.join(p.capitalize() for p in parts[1:])
+
+
+MESSAGE_KEYS = ('name', 'id', 'direction', 'doc', 'fields')
+FIELD_KEYS = ('name', 'type')
+
+
+def require(entry, keys, where):
+    missing = [key for key in keys if key not in entry]
+    if missing:
+        raise ValueError('%s: missing %s' % (where, ', '.join(missing)))
+
+
+def load_definition(path):
+    with open(path) as f:
+        definition = json.load(f)
+    require(definition, ('message_key', 'messages'), os.path.basename(path))
+    for index, message in enumerate(definition['messages']):
+        require(message, MESSAGE_KEYS, message.get('name', 'message #%d' % index))
+        for field_index, field in enumerate(message['fields']):
+            require(field, FIELD_KEYS, '%s.%s' % (message['name'], field.get('name', 'field #%d' % field_index)))
+    ids = set()
+    for message in definition['messages']:
+        if message['id'] in ids or not 0 < message['id'] < 256:
+            raise ValueError('bad or duplicate id for %s' % message['name'])
+        ids.add(message['id'])
+        fields = message['fields']
+        for index, field in enumerate(fields):
+            if field['type'] == 'bytes':
+                if index != len(fields) - 1:
+                    raise ValueError('%s.%s: bytes must be the last field' % (message['name'], field['name']))
+            elif field['type'] not in TYPE_WIDTHS:
+                raise ValueError('%s.%s: unknown type %s' % (message['name'], field['name'], field['type']))
+    return definition
+
+
+def fixed_size(message):
+    return sum(TYPE_WIDTHS[f['type']] * f.get('count', 1) for f in message['fields'] if f['type'] != 'bytes')
+
+
+def trailing_bytes(message):
+    fields = message['fields']
+    return fields[-1] if fields and fields[-1]['type'] == 'bytes' else None
+
+
+# ----- C ----------------------------------------------------------------------
+
+def c_header(definition):
+    out = ['#pragma once', '', '// ' + BANNER, '//',
+           '// Fixed-width little-endian bodies for every message in the protocol. comm.c',
+           '// frames them as [message id][body] in the %s message key.' % definition['message_key'],
+           '', '#include <stdbool.h>', '#include <stdint.h>', '',
+           'typedef enum {']
+    for message in definition['messages']:
+        out.append('  PROTO_MSG_%s = %d,' % (message['name'].upper(), message['id']))
+    out += ['} ProtoMessageId;', '']
+    for message in definition['messages']:
+        if not message['fields']:
+            continue
+        upper = message['name'].upper()
+        out.append('// %s (%s)' % (message['doc'], message['direction'].replace('_', ' ')))
+        out.append('#define PROTO_%s_FIXED_SIZE %d' % (upper, fixed_size(message)))
+        if message.get('mergeable'):
+            out.append('#define PROTO_%s_MERGEABLE 1' % upper)
+        out.append('typedef struct {')
+        for field in message['fields']:
+            if field['type'] == 'bytes':
+                out.append('  const uint8_t *%s;' % field['name'])
+                out.append('  uint16_t %s_length;' % field['name'])
+            elif 'count' in field:
+                out.append('  %s %s[%d];' % (C_TYPES[field['type']], field['name'], field['count']))
+            else:
+                out.append('  %s %s;' % (C_TYPES[field['type']], field['name']))
+        struct = 'Proto' + camel(message['name'], True)
+        out.append('} %s;' % struct)
+        out.append('')
+        out.append('// Writes the body into `out`; returns its length, or 0 if it does not fit.')
+        out.append('uint16_t proto_%s_pack(const %s *msg, uint8_t *out, uint16_t size);' % (message['name'], struct))
+        out.append('// Parses a body; trailing bytes point into `body`.')
+        out.append('bool proto_%s_unpack(const uint8_t *body, uint16_t length, %s *msg);' % (message['name'], struct))
+        out.append('')
+    return '\n'.join(out).rstrip() + '\n'
+
+
+def c_write_scalar(kind, target):
+    width = TYPE_WIDTHS[kind]
+    if width == 1:
+        return ['  out[offset++] = %s;' % target]
+    return ['  proto_put_%s(&out[offset], %s);' % (kind, target), '  offset += %d;' % width]
+
+
+def c_read_scalar(kind, target):
+    width = TYPE_WIDTHS[kind]
+    if width == 1:
+        return ['  %s = body[offset++];' % target]
+    return ['  %s = proto_get_%s(&body[offset]);' % (target, kind), '  offset += %d;' % width]
+
+
+def c_source(definition):
+    out = ['#include "protocol.h"', '', '#include <string.h>', '', '// ' + BANNER, '',
+           'static inline void proto_put_u16(uint8_t *p, uint16_t v) {',
+           '  p[0] = v & 0xFF;', '  p[1] = v >> 8;', '}', '',
+           'static inline void proto_put_u32(uint8_t *p, uint32_t v) {',
+           '  p[0] = v & 0xFF;', '  p[1] = (v >> 8) & 0xFF;', '  p[2] = (v >> 16) & 0xFF;', '  p[3] = v >> 24;', '}', '',
+           'static inline uint16_t proto_get_u16(const uint8_t *p) {',
+           '  return (uint16_t)(p[0] | (p[1] << 8));', '}', '',
+           'static inline uint32_t proto_get_u32(const uint8_t *p) {',
+           '  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);',
+           '}', '']
+    for message in definition['messages']:
+        if not message['fields']:
+            continue
+        name = message['name']
+        upper = name.upper()
+        struct = 'Proto' + camel(name, True)
+        tail = trailing_bytes(message)
+
+        out.append('uint16_t proto_%s_pack(const %s *msg, uint8_t *out, uint16_t size) {' % (name, struct))
+        need = 'PROTO_%s_FIXED_SIZE' % upper
+        if tail:
+            need += ' + msg->%s_length' % tail['name']
+        out.append('  if (%s > size) {' % need)
+        out.append('    return 0;')
+        out.append('  }')
+        out.append('  uint16_t offset = 0;')
+        for field in message['fields']:
+            if field['type'] == 'bytes':
+                out.append('  if (msg->%s_length > 0) {' % field['name'])
+                out.append('    memcpy(&out[offset], msg->%s, msg->%s_length);' % (field['name'], field['name']))
+                out.append('  }')
+                out.append('  offset += msg->%s_length;' % field['name'])
+            elif 'count' in field:
+                out.append('  for (int i = 0; i < %d; ++i) {' % field['count'])
+                out += ['  ' + line for line in c_write_scalar(field['type'], 'msg->%s[i]' % field['name'])]
+                out.append('  }')
+            else:
+                out += c_write_scalar(field['type'], 'msg->%s' % field['name'])
+        out.append('  return offset;')
+        out.append('}')
+        out.append('')
+
+        out.append('bool proto_%s_unpack(const uint8_t *body, uint16_t length, %s *msg) {' % (name, struct))
+        if fixed_size(message) > 0:
+            out.append('  if (length < PROTO_%s_FIXED_SIZE) {' % upper)
+            out.append('    return false;')
+            out.append('  }')
+        out.append('  uint16_t offset = 0;')
+        for field in message['fields']:
+            if field['type'] == 'bytes':
+                out.append('  msg->%s = &body[offset];' % field['name'])
+                out.append('  msg->%s_length = length - offset;' % field['name'])
+            elif 'count' in field:
+                out.append('  for (int i = 0; i < %d; ++i) {' % field['count'])
+                out += ['  ' + line for line in c_read_scalar(field['type'], 'msg->%s[i]' % field['name'])]
+                out.append('  }')
+            else:
+                out += c_read_scalar(field['type'], 'msg->%s' % field['name'])
+        if not tail:
+            out.append('  (void)offset;')
+        out.append('  return true;')
+        out.append('}')
+        out.append('')
+    return '\n'.join(out).rstrip() + '\n'
+
+
+# ----- JS ---------------------------------------------------------------------
+
+def js_source(definition):
+    out = ['// ' + BANNER, '//',
+           '// encode(name, fields) -> [id, ...body] for the %s key; decode(bytes) ->' % definition['message_key'],
+           '// {type: name, ...fields} or null. Field names are camelCase; "bytes" fields',
+           '// are plain arrays.', '',
+           "var MESSAGE_KEY = '%s';" % definition['message_key'], '',
+           'var IDS = {']
+    messages = definition['messages']
+    for i, message in enumerate(messages):
+        out.append("  %s: %d%s" % (camel(message['name'], False), message['id'], ',' if i < len(messages) - 1 else ''))
+    out += ['};', '',
+            'function putU16(out, v) {', '  out.push(v & 0xFF, (v >> 8) & 0xFF);', '}', '',
+            'function putU32(out, v) {',
+            '  out.push(v & 0xFF, (v >>> 8) & 0xFF, (v >>> 16) & 0xFF, (v >>> 24) & 0xFF);', '}', '',
+            'function getU16(b, o) {', '  return b[o] | (b[o + 1] << 8);', '}', '',
+            'function getU32(b, o) {', '  return (b[o] | (b[o + 1] << 8) | (b[o + 2] << 16) | (b[o + 3] << 24)) >>> 0;',
+            '}', '']
+    js_put = {'u8': 'out.push(%s & 0xFF);', 'u16': 'putU16(out, %s);', 'u32': 'putU32(out, %s);'}
+    js_get = {'u8': 'b[%s]', 'u16': 'getU16(b, %s)', 'u32': 'getU32(b, %s)'}
+
+    out.append('var ENCODERS = {')
+    for i, message in enumerate(messages):
+        key = camel(message['name'], False)
+        out.append('  %s: function(m, out) {' % key)
+        for field in message['fields']:
+            prop = 'm.' + camel(field['name'], False)
+            if field['type'] == 'bytes':
+                out.append('    for (var i = 0; i < (%s || []).length; i++) {' % prop)
+                out.append('      out.push(%s[i] & 0xFF);' % prop)
+                out.append('    }')
+            elif 'count' in field:
+                out.append('    for (var j = 0; j < %d; j++) {' % field['count'])
+                out.append('      ' + js_put[field['type']] % ('((%s || [])[j] || 0)' % prop))
+                out.append('    }')
+            else:
+                out.append('    ' + js_put[field['type']] % ('(%s || 0)' % prop))
+        out.append('  }%s' % (',' if i < len(messages) - 1 else ''))
+    out += ['};', '']
+
+    out.append('var DECODERS = {')
+    for i, message in enumerate(messages):
+        out.append('  %d: function(b) {' % message['id'])
+        size = fixed_size(message) + 1
+        out.append('    if (b.length < %d) {' % size)
+        out.append('      return null;')
+        out.append('    }')
+        out.append("    var m = {type: '%s'};" % camel(message['name'], False))
+        offset = 1
+        for field in message['fields']:
+            prop = 'm.' + camel(field['name'], False)
+            if field['type'] == 'bytes':
+                out.append('    %s = Array.prototype.slice.call(b, %d);' % (prop, offset))
+            elif 'count' in field:
+                width = TYPE_WIDTHS[field['type']]
+                out.append('    %s = [];' % prop)
+                out.append('    for (var j = 0; j < %d; j++) {' % field['count'])
+                out.append('      %s.push(%s);' % (prop, js_get[field['type']] % ('%d + j * %d' % (offset, width))))
+                out.append('    }')
+                offset += width * field['count']
+            else:
+                out.append('    %s = %s;' % (prop, js_get[field['type']] % offset))
+                offset += TYPE_WIDTHS[field['type']]
+        out.append('    return m;')
+        out.append('  }%s' % (',' if i < len(messages) - 1 else ''))
+    out += ['};', '',
+            'function encode(name, fields) {',
+            '  var out = [IDS[name]];',
+            '  ENCODERS[name](fields || {}, out);',
+            '  return out;',
+            '}', '',
+            'function decode(bytes) {',
+            '  var decoder = bytes && bytes.length > 0 ? DECODERS[bytes[0]] : null;',
+            '  return decoder ? decoder(bytes) : null;',
+            '}', '',
+            'module.exports = {MESSAGE_KEY: MESSAGE_KEY, IDS: IDS, encode: encode, decode: decode};']
+    return '\n'.join(out) + '\n'
+
+
+def check_message_key(definition):
+    with open(os.path.join(ROOT, 'package.json')) as f:
+        keys = json.load(f)['pebble'].get('messageKeys', [])
+    if definition['message_key'] not in keys:
+        raise ValueError('package.json messageKeys must include %s' % definition['message_key'])
+
+
+def generate(check_only=False):
+    definition = load_definition(DEFINITION)
+    check_message_key(definition)
+    contents = {
+        'c_header': c_header(definition),
+        'c_source': c_source(definition),
+        'js': js_source(definition),
+    }
+    stale = []
+    for name, path in OUTPUTS.items():
+        current = None
+        if os.path.exists(path):
+            with open(path) as f:
+                current = f.read()
+        if current != contents[name]:
+            stale.append(path)
+            if not check_only:
+                with open(path, 'w') as f:
+                    f.write(contents[name])
+    return stale
+
+
+if __name__ == '__main__':
+    check_only = '--check' in sys.argv[1:]
+    stale = generate(check_only)
+    for path in stale:
+        print('%s %s' % ('stale:' if check_only else 'wrote', os.path.relpath(path, ROOT)))
+    sys.exit(1 if check_only and stale else 0)
@@ -0,0 +1,214 @@
+#include "rng_check.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dicecore/model.h"
+#include "dicecore/rng.h"
+#include "dicecore/roll_pool.h"
+#include "rng_lanes.h"
+
+// -----------------------------------------------------------------------------
+// RNG CHECK MODULE
+// -----------------------------------------------------------------------------
+// Statistical smoke test for the dice generators (dicesim -c). Each die kind
+// is rolled the way the watch rolls it: the pool in roll_pool.c refilled in
+// ROLL_POOL_CAPACITY batches and drained with roll_pool_take(), then
+// normalised by model_kind_face_value(), so a d100 must only show 00-90 in
+// tens and a d% 00-99. The host lanes generator (on the ISA dicesim would
+// pick; all ISAs give the same draws) is checked the same way, so a faster
+// generator can't slip in a bias unnoticed.
+//
+// Per kind and path, in face order:
+// - chi-square over the faces (Wilson-Hilferty z; only an excess fails),
+// - the mean face, which catches modulo bias (it always favours low faces)
+//   with far fewer draws than chi-square,
+// - lag-1 serial correlation, z = r * sqrt(n),
+// - Wald-Wolfowitz runs above/below the middle face (ties skipped).
+// A face the kind can't show fails outright.
+//
+// Safe tweaks:
+// - RNG_CHECK_Z_MAX in rng_check.h trades false alarms against sensitivity;
+//   64 statistics run per check.
+// - BLOCK_SIZE only sets how many draws are buffered at a time.
+
+#define BLOCK_SIZE 4096
+
+typedef enum {
+  SOURCE_POOL,
+  SOURCE_LANES,
+} SourceKind;
+
+typedef struct {
+  SourceKind kind;
+  RngLanesIsa isa;
+  RngLanes lanes;
+  RollPool pool;
+} Source;
+
+// Running sums over one kind's face indices (0..sides-1).
+typedef struct {
+  uint32_t sides;
+  uint64_t counts[RNG_LANES_RANGE_MAX];
+  uint64_t n;
+  uint64_t invalid;
+  double sum;
+  double sum_sq;
+  double sum_lag;
+  int64_t previous;
+  uint64_t above;
+  uint64_t below;
+  uint64_t runs;
+  int previous_side;
+} Stats;
+
+static void prv_draw_block(Source *source, uint32_t range, int *out, int n) {
+  if (source->kind == SOURCE_POOL) {
+    for (int i = 0; i < n; ++i) {
+      if (source->pool.level == 0) {
+        roll_pool_fill(&source->pool, ROLL_POOL_CAPACITY);
+      }
+      out[i] = roll_pool_take(&source->pool, (int)range);
+    }
+    return;
+  }
+  for (int i = 0; i < n; i += RNG_LANES) {
+    uint32_t acc[RNG_LANES] = {0};
+    rng_lanes_sum(&source->lanes, source->isa, range, 1, acc);
+    for (int lane = 0; lane < RNG_LANES && i + lane < n; ++lane) {
+      out[i + lane] = (int)acc[lane] + 1;
+    }
+  }
+}
+
+static void prv_stats_add(Stats *stats, int64_t index) {
+  stats->counts[index]++;
+  stats->n++;
+  stats->sum += (double)index;
+  stats->sum_sq += (double)index * index;
+  if (stats->previous >= 0) {
+    stats->sum_lag += (double)stats->previous * index;
+  }
+  stats->previous = index;
+
+  // Runs above/below the middle face; an odd die's middle face is skipped.
+  const int64_t twice = 2 * index - (int64_t)(stats->sides - 1);
+  if (twice == 0) {
+    return;
+  }
+  const int side = twice > 0 ? 1 : -1;
+  if (side > 0) {
+    stats->above++;
+  } else {
+    stats->below++;
+  }
+  if (side != stats->previous_side) {
+    stats->runs++;
+    stats->previous_side = side;
+  }
+}
+
+// Wilson-Hilferty: chi-square with k degrees of freedom as a standard normal.
+static double prv_chi_square_z(const Stats *stats) {
+  const double expected = (double)stats->n / stats->sides;
+  double chi = 0;
+  for (uint32_t face = 0; face < stats->sides; ++face) {
+    const double delta = stats->counts[face] - expected;
+    chi += delta * delta / expected;
+  }
+  const double k = stats->sides - 1;
+  return (cbrt(chi / k) - (1 - 2 / (9 * k))) / sqrt(2 / (9 * k));
+}
+
+static double prv_mean_z(const Stats *stats) {
+  const double n = (double)stats->n;
+  const double sides = stats->sides;
+  return (stats->sum / n - (sides - 1) / 2) / sqrt((sides * sides - 1) / 12 / n);
+}
+
+static double prv_serial_z(const Stats *stats) {
+  const double n = (double)stats->n;
+  const double mean = stats->sum / n;
+  const double variance = stats->sum_sq / n - mean * mean;
+  const double covariance = stats->sum_lag / (n - 1) - mean * mean;
+  return variance > 0 ? covariance / variance * sqrt(n) : 0;
+}
+
+static double prv_runs_z(const Stats *stats) {
+  const double n1 = (double)stats->above;
+  const double n2 = (double)stats->below;
+  const double n = n1 + n2;
+  if (n1 == 0 || n2 == 0) {
+    return 0;
+  }
+  const double mean = 2 * n1 * n2 / n + 1;
+  const double variance = (mean - 1) * (mean - 2) / (n - 1);
+  return (stats->runs - mean) / sqrt(variance);
+}
+
+// Rolls one kind from one source and prints its line; true if it passed.
+static bool prv_check_kind(Source *source, DiceKind kind, uint64_t draws) {
+  static Stats s_stats;
+  static int s_block[BLOCK_SIZE];
+  const uint32_t sides = (uint32_t)model_kind_roll_sides(kind);
+  const int first = model_kind_face_value(kind, 1);
+  const int step = sides > 1 ? model_kind_face_value(kind, 2) - first : 1;
+
+  memset(&s_stats, 0, sizeof(s_stats));
+  s_stats.sides = sides;
+  s_stats.previous = -1;
+  if (source->kind == SOURCE_POOL) {
+    roll_pool_reset(&source->pool, (int)sides);
+  }
+  for (uint64_t done = 0; done < draws; done += BLOCK_SIZE) {
+    const int n = (draws - done < BLOCK_SIZE) ? (int)(draws - done) : BLOCK_SIZE;
+    prv_draw_block(source, sides, s_block, n);
+    for (int i = 0; i < n; ++i) {
+      const int face = model_kind_face_value(kind, s_block[i]);
+      const int64_t index = step > 0 ? (face - first) / step : -1;
+      if (index < 0 || index >= (int64_t)sides || first + step * index != face) {
+        s_stats.invalid++;
+        continue;
+      }
+      prv_stats_add(&s_stats, index);
+    }
+  }
+
+  const double chi_z = prv_chi_square_z(&s_stats);
+  const double mean_z = prv_mean_z(&s_stats);
+  const double serial_z = prv_serial_z(&s_stats);
+  const double runs_z = prv_runs_z(&s_stats);
+  const bool ok = s_stats.invalid == 0 && chi_z <= RNG_CHECK_Z_MAX && fabs(mean_z) <= RNG_CHECK_Z_MAX &&
+                  fabs(serial_z) <= RNG_CHECK_Z_MAX && fabs(runs_z) <= RNG_CHECK_Z_MAX;
+  printf("%-5s %-12s %9.2f %9.2f %9.2f %9.2f %9llu  %s\n", model_kind_label(kind),
+         source->kind == SOURCE_POOL ? "roll_pool" : rng_lanes_isa_name(source->isa), chi_z, mean_z, serial_z,
+         runs_z, (unsigned long long)s_stats.invalid, ok ? "ok" : "BIASED");
+  return ok;
+}
+
+int rng_check_run(uint64_t draws, const uint32_t seed[4]) {
+  static Source s_source;
+  RngState base;
+  rng_seed(&base, seed);
+  int failures = 0;
+
+  printf("%llu draws per kind and path; fail beyond z = %.1f\n", (unsigned long long)draws, RNG_CHECK_Z_MAX);
+  printf("%-5s %-12s %9s %9s %9s %9s %9s\n", "kind", "path", "chi2 z", "mean z", "serial z", "runs z", "bad faces");
+  for (int path = 0; path < 2; ++path) {
+    memset(&s_source, 0, sizeof(s_source));
+    if (path == 0) {
+      s_source.kind = SOURCE_POOL;
+      rng_reseed(seed);
+    } else {
+      s_source.kind = SOURCE_LANES;
+      s_source.isa = rng_lanes_best_isa();
+      rng_lanes_seed(&s_source.lanes, &base);
+    }
+    for (int kind = 0; kind < DICE_KIND_COUNT; ++kind) {
+      failures += prv_check_kind(&s_source, (DiceKind)kind, draws) ? 0 : 1;
+    }
+  }
+  return failures;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+// Beyond this many standard deviations a statistic counts as biased.
+#define RNG_CHECK_Z_MAX 4.5
+
+// Draws `draws` values per die kind from both generator paths (the app's roll
+// pool and the rng_lanes generator), maps them to faces with
+// model_kind_face_value() and runs chi-square, mean, serial-correlation and
+// runs tests on each. Prints one line per kind and path; returns how many
+// failed.
+int rng_check_run(uint64_t draws, const uint32_t seed[4]);
@@ -0,0 +1,387 @@
+#include "rng_lanes.h"
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// RNG LANES MODULE
+// -----------------------------------------------------------------------------
+// Host-only, eight-lane version of the dicecore generator for bulk Monte Carlo
+// (tools/dicesim.c). Each lane is plain xoshiro128**; the range reduction is
+// the same multiply-shift as rng_bounded(), done on all lanes at once with
+// 32x32->64 multiplies, so no lane branches on its value. The rare draw that
+// multiply-shift would bias (low word under the threshold) is redrawn for the
+// affected lanes only; every lane still advances, which keeps the scalar,
+// SSE2 and AVX2 versions bit-identical for a given seed.
+//
+// The x86 paths are compiled with target attributes and picked at run time,
+// so a default -O2 build still uses AVX2 where the CPU has it. Other hosts get
+// the scalar loops, which compilers auto-vectorise reasonably well.
+//
+// Safe tweaks:
+// - Add an ISA by extending RngLanesIsa and the two dispatch switches.
+// - Raise RNG_LANES_RANGE_MAX for wider dice; it sizes a stack array here.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RNG_LANES_X86 1
+#include <immintrin.h>
+#else
+#define RNG_LANES_X86 0
+#endif
+
+static const char *s_isa_names[RNG_LANES_ISA_COUNT] = {"scalar", "sse2", "avx2"};
+
+// Multiply-shift keeps m >> 32 unless the low word falls under this.
+static uint32_t prv_threshold(uint32_t range) {
+  return (0u - range) % range;
+}
+
+static inline uint32_t prv_rotl(uint32_t x, int k) {
+  return (x << k) | (x >> (32 - k));
+}
+
+// ----- Scalar --------------------------------------------------------------
+
+static inline void prv_next_scalar(RngLanes *lanes, uint32_t out[RNG_LANES]) {
+  uint32_t (*s)[RNG_LANES] = lanes->s;
+  for (int i = 0; i < RNG_LANES; ++i) {
+    out[i] = prv_rotl(s[1][i] * 5, 7) * 9;
+    const uint32_t t = s[1][i] << 9;
+    s[2][i] ^= s[0][i];
+    s[3][i] ^= s[1][i];
+    s[1][i] ^= s[2][i];
+    s[0][i] ^= s[3][i];
+    s[2][i] ^= t;
+    s[3][i] = prv_rotl(s[3][i], 11);
+  }
+}
+
+static inline void prv_bounded_scalar(RngLanes *lanes, uint32_t range, uint32_t threshold,
+                                      uint32_t hi[RNG_LANES]) {
+  uint32_t x[RNG_LANES];
+  uint32_t bad = 0;
+  prv_next_scalar(lanes, x);
+  for (int i = 0; i < RNG_LANES; ++i) {
+    const uint64_t m = (uint64_t)x[i] * range;
+    hi[i] = (uint32_t)(m >> 32);
+    bad |= (uint32_t)((uint32_t)m < threshold) << i;
+  }
+  while (bad) {
+    uint32_t still = 0;
+    prv_next_scalar(lanes, x);
+    for (int i = 0; i < RNG_LANES; ++i) {
+      const uint64_t m = (uint64_t)x[i] * range;
+      if (bad & (1u << i)) {
+        hi[i] = (uint32_t)(m >> 32);
+        still |= (uint32_t)((uint32_t)m < threshold) << i;
+      }
+    }
+    bad = still;
+  }
+}
+
+static void prv_sum_scalar(RngLanes *lanes, uint32_t range, int count, uint32_t acc[RNG_LANES]) {
+  const uint32_t threshold = prv_threshold(range);
+  uint32_t hi[RNG_LANES];
+  for (int d = 0; d < count; ++d) {
+    prv_bounded_scalar(lanes, range, threshold, hi);
+    for (int i = 0; i < RNG_LANES; ++i) {
+      acc[i] += hi[i];
+    }
+  }
+}
+
+static void prv_histogram_scalar(RngLanes *lanes, uint32_t range, uint64_t rounds,
+                                 uint64_t counts[RNG_LANES][RNG_LANES_RANGE_MAX]) {
+  const uint32_t threshold = prv_threshold(range);
+  uint32_t hi[RNG_LANES];
+  for (uint64_t r = 0; r < rounds; ++r) {
+    prv_bounded_scalar(lanes, range, threshold, hi);
+    for (int i = 0; i < RNG_LANES; ++i) {
+      counts[i][hi[i]]++;
+    }
+  }
+}
+
+#if RNG_LANES_X86
+
+// ----- SSE2: two halves of four lanes ---------------------------------------
+// SSE2 has no 32-bit mullo, but *5 and *9 are a shift and an add.
+
+__attribute__((target("sse2")))
+static inline __m128i prv_next_sse2(__m128i s[4]) {
+  __m128i r = _mm_add_epi32(_mm_slli_epi32(s[1], 2), s[1]);
+  r = _mm_or_si128(_mm_slli_epi32(r, 7), _mm_srli_epi32(r, 25));
+  r = _mm_add_epi32(_mm_slli_epi32(r, 3), r);
+  const __m128i t = _mm_slli_epi32(s[1], 9);
+  s[2] = _mm_xor_si128(s[2], s[0]);
+  s[3] = _mm_xor_si128(s[3], s[1]);
+  s[1] = _mm_xor_si128(s[1], s[2]);
+  s[0] = _mm_xor_si128(s[0], s[3]);
+  s[2] = _mm_xor_si128(s[2], t);
+  s[3] = _mm_or_si128(_mm_slli_epi32(s[3], 11), _mm_srli_epi32(s[3], 21));
+  return r;
+}
+
+// High and low words of x * range per lane, from even and odd 32x32->64
+// products.
+__attribute__((target("sse2")))
+static inline void prv_mul_sse2(__m128i x, __m128i range, __m128i *hi, __m128i *lo) {
+  const __m128i high_mask = _mm_set1_epi64x((long long)0xFFFFFFFF00000000ull);
+  const __m128i even = _mm_mul_epu32(x, range);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(x, 32), range);
+  *hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_and_si128(odd, high_mask));
+  *lo = _mm_or_si128(_mm_andnot_si128(high_mask, even), _mm_slli_epi64(odd, 32));
+}
+
+// Lanes whose low word is under the threshold (unsigned, via the sign flip).
+__attribute__((target("sse2")))
+static inline __m128i prv_reject_sse2(__m128i lo, __m128i threshold_flipped) {
+  return _mm_cmpgt_epi32(threshold_flipped, _mm_xor_si128(lo, _mm_set1_epi32((int)0x80000000u)));
+}
+
+__attribute__((target("sse2")))
+static inline void prv_bounded_sse2(__m128i s[2][4], __m128i range, __m128i threshold_flipped, __m128i hi[2]) {
+  __m128i bad[2];
+  for (int h = 0; h < 2; ++h) {
+    __m128i lo;
+    prv_mul_sse2(prv_next_sse2(s[h]), range, &hi[h], &lo);
+    bad[h] = prv_reject_sse2(lo, threshold_flipped);
+  }
+  while (_mm_movemask_epi8(_mm_or_si128(bad[0], bad[1]))) {
+    for (int h = 0; h < 2; ++h) {
+      __m128i redraw, lo;
+      prv_mul_sse2(prv_next_sse2(s[h]), range, &redraw, &lo);
+      hi[h] = _mm_or_si128(_mm_and_si128(bad[h], redraw), _mm_andnot_si128(bad[h], hi[h]));
+      bad[h] = _mm_and_si128(bad[h], prv_reject_sse2(lo, threshold_flipped));
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static void prv_load_sse2(const RngLanes *lanes, __m128i s[2][4]) {
+  for (int h = 0; h < 2; ++h) {
+    for (int w = 0; w < 4; ++w) {
+      s[h][w] = _mm_load_si128((const __m128i *)&lanes->s[w][h * 4]);
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static void prv_store_sse2(RngLanes *lanes, __m128i s[2][4]) {
+  for (int h = 0; h < 2; ++h) {
+    for (int w = 0; w < 4; ++w) {
+      _mm_store_si128((__m128i *)&lanes->s[w][h * 4], s[h][w]);
+    }
+  }
+}
+
+__attribute__((target("sse2")))
+static void prv_sum_sse2(RngLanes *lanes, uint32_t range, int count, uint32_t acc[RNG_LANES]) {
+  __m128i s[2][4];
+  __m128i hi[2];
+  prv_load_sse2(lanes, s);
+  const __m128i range_v = _mm_set1_epi32((int)range);
+  const __m128i threshold_v = _mm_set1_epi32((int)(prv_threshold(range) ^ 0x80000000u));
+  __m128i sum[2] = {_mm_loadu_si128((const __m128i *)&acc[0]), _mm_loadu_si128((const __m128i *)&acc[4])};
+  for (int d = 0; d < count; ++d) {
+    prv_bounded_sse2(s, range_v, threshold_v, hi);
+    sum[0] = _mm_add_epi32(sum[0], hi[0]);
+    sum[1] = _mm_add_epi32(sum[1], hi[1]);
+  }
+  _mm_storeu_si128((__m128i *)&acc[0], sum[0]);
+  _mm_storeu_si128((__m128i *)&acc[4], sum[1]);
+  prv_store_sse2(lanes, s);
+}
+
+__attribute__((target("sse2")))
+static void prv_histogram_sse2(RngLanes *lanes, uint32_t range, uint64_t rounds,
+                               uint64_t counts[RNG_LANES][RNG_LANES_RANGE_MAX]) {
+  __m128i s[2][4];
+  __m128i hi[2];
+  uint32_t faces[RNG_LANES] __attribute__((aligned(16)));
+  prv_load_sse2(lanes, s);
+  const __m128i range_v = _mm_set1_epi32((int)range);
+  const __m128i threshold_v = _mm_set1_epi32((int)(prv_threshold(range) ^ 0x80000000u));
+  for (uint64_t r = 0; r < rounds; ++r) {
+    prv_bounded_sse2(s, range_v, threshold_v, hi);
+    _mm_store_si128((__m128i *)&faces[0], hi[0]);
+    _mm_store_si128((__m128i *)&faces[4], hi[1]);
+    for (int i = 0; i < RNG_LANES; ++i) {
+      counts[i][faces[i]]++;
+    }
+  }
+  prv_store_sse2(lanes, s);
+}
+
+// ----- AVX2: all eight lanes in one register --------------------------------
+
+__attribute__((target("avx2")))
+static inline __m256i prv_next_avx2(__m256i s[4]) {
+  __m256i r = _mm256_add_epi32(_mm256_slli_epi32(s[1], 2), s[1]);
+  r = _mm256_or_si256(_mm256_slli_epi32(r, 7), _mm256_srli_epi32(r, 25));
+  r = _mm256_add_epi32(_mm256_slli_epi32(r, 3), r);
+  const __m256i t = _mm256_slli_epi32(s[1], 9);
+  s[2] = _mm256_xor_si256(s[2], s[0]);
+  s[3] = _mm256_xor_si256(s[3], s[1]);
+  s[1] = _mm256_xor_si256(s[1], s[2]);
+  s[0] = _mm256_xor_si256(s[0], s[3]);
+  s[2] = _mm256_xor_si256(s[2], t);
+  s[3] = _mm256_or_si256(_mm256_slli_epi32(s[3], 11), _mm256_srli_epi32(s[3], 21));
+  return r;
+}
+
+__attribute__((target("avx2")))
+static inline void prv_mul_avx2(__m256i x, __m256i range, __m256i *hi, __m256i *lo) {
+  const __m256i high_mask = _mm256_set1_epi64x((long long)0xFFFFFFFF00000000ull);
+  const __m256i even = _mm256_mul_epu32(x, range);
+  const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), range);
+  *hi = _mm256_or_si256(_mm256_srli_epi64(even, 32), _mm256_and_si256(odd, high_mask));
+  *lo = _mm256_or_si256(_mm256_andnot_si256(high_mask, even), _mm256_slli_epi64(odd, 32));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i prv_reject_avx2(__m256i lo, __m256i threshold_flipped) {
+  return _mm256_cmpgt_epi32(threshold_flipped, _mm256_xor_si256(lo, _mm256_set1_epi32((int)0x80000000u)));
+}
+
+__attribute__((target("avx2")))
+static inline __m256i prv_bounded_avx2(__m256i s[4], __m256i range, __m256i threshold_flipped) {
+  __m256i hi, lo;
+  prv_mul_avx2(prv_next_avx2(s), range, &hi, &lo);
+  __m256i bad = prv_reject_avx2(lo, threshold_flipped);
+  while (!_mm256_testz_si256(bad, bad)) {
+    __m256i redraw;
+    prv_mul_avx2(prv_next_avx2(s), range, &redraw, &lo);
+    hi = _mm256_blendv_epi8(hi, redraw, bad);
+    bad = _mm256_and_si256(bad, prv_reject_avx2(lo, threshold_flipped));
+  }
+  return hi;
+}
+
+__attribute__((target("avx2")))
+static void prv_sum_avx2(RngLanes *lanes, uint32_t range, int count, uint32_t acc[RNG_LANES]) {
+  __m256i s[4];
+  for (int w = 0; w < 4; ++w) {
+    s[w] = _mm256_load_si256((const __m256i *)lanes->s[w]);
+  }
+  const __m256i range_v = _mm256_set1_epi32((int)range);
+  const __m256i threshold_v = _mm256_set1_epi32((int)(prv_threshold(range) ^ 0x80000000u));
+  __m256i sum = _mm256_loadu_si256((const __m256i *)acc);
+  for (int d = 0; d < count; ++d) {
+    sum = _mm256_add_epi32(sum, prv_bounded_avx2(s, range_v, threshold_v));
+  }
+  _mm256_storeu_si256((__m256i *)acc, sum);
+  for (int w = 0; w < 4; ++w) {
+    _mm256_store_si256((__m256i *)lanes->s[w], s[w]);
+  }
+}
+
+__attribute__((target("avx2")))
+static void prv_histogram_avx2(RngLanes *lanes, uint32_t range, uint64_t rounds,
+                               uint64_t counts[RNG_LANES][RNG_LANES_RANGE_MAX]) {
+  __m256i s[4];
+  uint32_t faces[RNG_LANES] __attribute__((aligned(32)));
+  for (int w = 0; w < 4; ++w) {
+    s[w] = _mm256_load_si256((const __m256i *)lanes->s[w]);
+  }
+  const __m256i range_v = _mm256_set1_epi32((int)range);
+  const __m256i threshold_v = _mm256_set1_epi32((int)(prv_threshold(range) ^ 0x80000000u));
+  for (uint64_t r = 0; r < rounds; ++r) {
+    _mm256_store_si256((__m256i *)faces, prv_bounded_avx2(s, range_v, threshold_v));
+    for (int i = 0; i < RNG_LANES; ++i) {
+      counts[i][faces[i]]++;
+    }
+  }
+  for (int w = 0; w < 4; ++w) {
+    _mm256_store_si256((__m256i *)lanes->s[w], s[w]);
+  }
+}
+
+#endif  // RNG_LANES_X86
+
+// ----- Public API -------------------------------------------------------------
+
+bool rng_lanes_isa_supported(RngLanesIsa isa) {
+  switch (isa) {
+    case RNG_LANES_SCALAR:
+      return true;
+#if RNG_LANES_X86
+    case RNG_LANES_SSE2:
+      return __builtin_cpu_supports("sse2");
+    case RNG_LANES_AVX2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+RngLanesIsa rng_lanes_best_isa(void) {
+  for (int isa = RNG_LANES_ISA_COUNT - 1; isa > RNG_LANES_SCALAR; --isa) {
+    if (rng_lanes_isa_supported((RngLanesIsa)isa)) {
+      return (RngLanesIsa)isa;
+    }
+  }
+  return RNG_LANES_SCALAR;
+}
+
+const char *rng_lanes_isa_name(RngLanesIsa isa) {
+  return (isa >= 0 && isa < RNG_LANES_ISA_COUNT) ? s_isa_names[isa] : "?";
+}
+
+void rng_lanes_seed(RngLanes *lanes, const RngState *base) {
+  RngState rng = *base;
+  for (int i = 0; i < RNG_LANES; ++i) {
+    for (int w = 0; w < 4; ++w) {
+      lanes->s[w][i] = rng.s[w];
+    }
+    rng_jump(&rng);
+  }
+}
+
+void rng_lanes_sum(RngLanes *lanes, RngLanesIsa isa, uint32_t range, int count, uint32_t acc[RNG_LANES]) {
+  if (range == 0 || count <= 0) {
+    return;
+  }
+  switch (rng_lanes_isa_supported(isa) ? isa : RNG_LANES_SCALAR) {
+#if RNG_LANES_X86
+    case RNG_LANES_AVX2:
+      prv_sum_avx2(lanes, range, count, acc);
+      return;
+    case RNG_LANES_SSE2:
+      prv_sum_sse2(lanes, range, count, acc);
+      return;
+#endif
+    default:
+      prv_sum_scalar(lanes, range, count, acc);
+      return;
+  }
+}
+
+void rng_lanes_histogram(RngLanes *lanes, RngLanesIsa isa, uint32_t range, uint64_t rounds, uint64_t *counts) {
+  if (range == 0 || range > RNG_LANES_RANGE_MAX) {
+    return;
+  }
+  // One table per lane: back-to-back increments of the same face would
+  // otherwise serialise on the store.
+  uint64_t lane_counts[RNG_LANES][RNG_LANES_RANGE_MAX];
+  memset(lane_counts, 0, sizeof(lane_counts));
+  switch (rng_lanes_isa_supported(isa) ? isa : RNG_LANES_SCALAR) {
+#if RNG_LANES_X86
+    case RNG_LANES_AVX2:
+      prv_histogram_avx2(lanes, range, rounds, lane_counts);
+      break;
+    case RNG_LANES_SSE2:
+      prv_histogram_sse2(lanes, range, rounds, lane_counts);
+      break;
+#endif
+    default:
+      prv_histogram_scalar(lanes, range, rounds, lane_counts);
+      break;
+  }
+  for (int i = 0; i < RNG_LANES; ++i) {
+    for (uint32_t face = 0; face < range; ++face) {
+      counts[face] += lane_counts[i][face];
+    }
+  }
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dicecore/rng.h"
+
+#define RNG_LANES 8
+// Largest range rng_lanes_histogram() counts (a d% draws 100).
+#define RNG_LANES_RANGE_MAX 256
+
+// Eight xoshiro128** generators side by side, one state word per row, so a
+// vector register holds the same word of every lane.
+typedef struct {
+  uint32_t s[4][RNG_LANES] __attribute__((aligned(32)));
+} RngLanes;
+
+typedef enum {
+  RNG_LANES_SCALAR,
+  RNG_LANES_SSE2,
+  RNG_LANES_AVX2,
+  RNG_LANES_ISA_COUNT
+} RngLanesIsa;
+
+// Widest implementation this CPU runs.
+RngLanesIsa rng_lanes_best_isa(void);
+bool rng_lanes_isa_supported(RngLanesIsa isa);
+const char *rng_lanes_isa_name(RngLanesIsa isa);
+
+// Lane i starts i * 2^64 draws into `base` (rng_jump), so lanes never overlap.
+// Jump `base` RNG_LANES more times before seeding the next RngLanes.
+void rng_lanes_seed(RngLanes *lanes, const RngState *base);
+// Adds `count` draws in [0, range) to each lane's acc. Unbiased, like
+// rng_bounded(); every ISA gives the same values for the same state.
+void rng_lanes_sum(RngLanes *lanes, RngLanesIsa isa, uint32_t range, int count, uint32_t acc[RNG_LANES]);
+// Draws rounds * RNG_LANES values in [0, range) and adds them to per-face
+// counts[0..range-1]. range must be 1..RNG_LANES_RANGE_MAX.
+void rng_lanes_histogram(RngLanes *lanes, RngLanesIsa isa, uint32_t range, uint64_t rounds, uint64_t *counts);